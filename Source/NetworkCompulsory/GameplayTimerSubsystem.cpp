@@ -0,0 +1,371 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "GameplayTimerSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
+
+namespace GameplayTimers
+{
+	/** Lists all pending gameplay timers for the current world */
+	static FAutoConsoleCommandWithWorld DumpTimersCommand(
+		TEXT("nc.Timers.Dump"),
+		TEXT("Lists all pending gameplay timers, grouped by owner"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UGameplayTimerSubsystem* Timers = World ? World->GetSubsystem<UGameplayTimerSubsystem>() : nullptr)
+			{
+				Timers->DumpTimers();
+			}
+		})
+	);
+}
+
+void UGameplayTimerSubsystem::SetTimer(FGameplayTimerHandle& InOutHandle, const UObject* Owner, FTimerDelegate Delegate, float Delay)
+{
+	// replace any timer the handle is already referencing
+	ClearTimer(InOutHandle);
+
+	// ignore unbound callbacks
+	if (!Delegate.IsBound())
+	{
+		return;
+	}
+
+	const int32 NodeIndex = AllocateNode();
+	FTimerNode& Node = Nodes[NodeIndex];
+
+	// expire at least one tick in the future, and never earlier than requested
+	const uint64 DelayTicks = FMath::Max<uint64>(1, FMath::CeilToInt64((FMath::Max(Delay, 0.0f) + Accumulator) / TickResolution));
+
+	Node.Delegate = MoveTemp(Delegate);
+	Node.Owner = Owner;
+	Node.Duration = Delay;
+	Node.ExpireTick = CurrentTick + DelayTicks;
+	Node.bActive = true;
+
+	LinkNode(NodeIndex);
+
+	++NumActiveTimers;
+
+	// issue the handle
+	InOutHandle.Index = NodeIndex;
+	InOutHandle.Serial = Node.Serial;
+}
+
+void UGameplayTimerSubsystem::ClearTimer(FGameplayTimerHandle& InOutHandle)
+{
+	// is the handle still referencing a scheduled timer?
+	if (FindNode(InOutHandle))
+	{
+		UnlinkNode(InOutHandle.Index);
+		ReleaseNode(InOutHandle.Index);
+	}
+
+	InOutHandle.Invalidate();
+}
+
+void UGameplayTimerSubsystem::ClearAllTimersForOwner(const UObject* Owner)
+{
+	if (!Owner)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		if (Nodes[i].bActive && Nodes[i].Owner.Get() == Owner)
+		{
+			UnlinkNode(i);
+			ReleaseNode(i);
+		}
+	}
+}
+
+bool UGameplayTimerSubsystem::IsTimerActive(const FGameplayTimerHandle& Handle) const
+{
+	return FindNode(Handle) != nullptr;
+}
+
+float UGameplayTimerSubsystem::GetTimerRemaining(const FGameplayTimerHandle& Handle) const
+{
+	if (const FTimerNode* Node = FindNode(Handle))
+	{
+		return FMath::Max(0.0f, (Node->ExpireTick - CurrentTick) * TickResolution - Accumulator);
+	}
+
+	return -1.0f;
+}
+
+void UGameplayTimerSubsystem::DumpTimers() const
+{
+	// group the active timers by owner
+	TMap<FString, TArray<const FTimerNode*>> TimersByOwner;
+
+	for (const FTimerNode& Node : Nodes)
+	{
+		if (Node.bActive)
+		{
+			TimersByOwner.FindOrAdd(GetNameSafe(Node.Owner.Get())).Add(&Node);
+		}
+	}
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Gameplay timers: %d active, %d pooled, tick %llu"), NumActiveTimers, Nodes.Num(), CurrentTick);
+
+	for (const TPair<FString, TArray<const FTimerNode*>>& Pair : TimersByOwner)
+	{
+		UE_LOG(LogNetworkCompulsory, Display, TEXT("  %s (%d)"), *Pair.Key, Pair.Value.Num());
+
+		for (const FTimerNode* Node : Pair.Value)
+		{
+			const float Remaining = FMath::Max(0.0f, (Node->ExpireTick - CurrentTick) * TickResolution - Accumulator);
+
+			UE_LOG(LogNetworkCompulsory, Display, TEXT("    %.2fs / %.2fs (level %d)"), Remaining, Node->Duration, Node->Level);
+		}
+	}
+}
+
+void UGameplayTimerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// clear all wheel slots
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+		{
+			Wheel[Level][Slot] = INDEX_NONE;
+		}
+	}
+}
+
+void UGameplayTimerSubsystem::Deinitialize()
+{
+	// drop all pending timers without firing them
+	Nodes.Empty();
+	ExpiredTimers.Empty();
+	FreeList = INDEX_NONE;
+	NumActiveTimers = 0;
+
+	Super::Deinitialize();
+}
+
+void UGameplayTimerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// DeltaTime is already dilated, and we don't tick while the world is paused
+	Accumulator += DeltaTime;
+
+	// advance the wheel one tick at a time, collecting expired timers
+	while (Accumulator >= TickResolution)
+	{
+		Accumulator -= TickResolution;
+		AdvanceTick();
+	}
+
+	// fire all expired timers in a single batch.
+	// Callbacks may set or clear timers, so we validate each handle before firing
+	for (int32 i = 0; i < ExpiredTimers.Num(); ++i)
+	{
+		const FGameplayTimerHandle Handle = ExpiredTimers[i];
+
+		if (FindNode(Handle))
+		{
+			// release the node before firing so the callback can reschedule using the same handle
+			FTimerDelegate Delegate = MoveTemp(Nodes[Handle.Index].Delegate);
+			ReleaseNode(Handle.Index);
+
+			Delegate.ExecuteIfBound();
+		}
+	}
+
+	ExpiredTimers.Reset();
+}
+
+TStatId UGameplayTimerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayTimerSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+bool UGameplayTimerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UGameplayTimerSubsystem::AllocateNode()
+{
+	// reuse a free node if we have one
+	if (FreeList != INDEX_NONE)
+	{
+		const int32 NodeIndex = FreeList;
+		FreeList = Nodes[NodeIndex].Next;
+
+		Nodes[NodeIndex].Prev = INDEX_NONE;
+		Nodes[NodeIndex].Next = INDEX_NONE;
+
+		return NodeIndex;
+	}
+
+	// grow the pool
+	LLM_SCOPE_BYTAG(NCTimers);
+	return Nodes.AddDefaulted();
+}
+
+void UGameplayTimerSubsystem::ReleaseNode(int32 NodeIndex)
+{
+	FTimerNode& Node = Nodes[NodeIndex];
+
+	if (Node.bActive)
+	{
+		--NumActiveTimers;
+	}
+
+	// bump the generation so outstanding handles become stale
+	++Node.Serial;
+	Node.bActive = false;
+	Node.Delegate.Unbind();
+	Node.Owner.Reset();
+
+	// push the node on the free list
+	Node.Prev = INDEX_NONE;
+	Node.Next = FreeList;
+	FreeList = NodeIndex;
+}
+
+void UGameplayTimerSubsystem::LinkNode(int32 NodeIndex)
+{
+	FTimerNode& Node = Nodes[NodeIndex];
+
+	// find the lowest level whose range covers the remaining ticks
+	const uint64 Delta = Node.ExpireTick - CurrentTick;
+
+	int32 Level = 0;
+
+	while (Level < NumLevels - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	// clamp timers beyond the wheel's range to the last slot of the top level. They'll cascade back in when reached
+	uint64 ExpireTick = Node.ExpireTick;
+
+	if (Delta >= (uint64(1) << (SlotBits * NumLevels)))
+	{
+		ExpireTick = CurrentTick + (uint64(1) << (SlotBits * NumLevels)) - 1;
+	}
+
+	const int32 Slot = int32((ExpireTick >> (SlotBits * Level)) & (NumSlots - 1));
+
+	// push the node at the head of the slot list
+	Node.Level = uint8(Level);
+	Node.Slot = uint8(Slot);
+	Node.Prev = INDEX_NONE;
+	Node.Next = Wheel[Level][Slot];
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = NodeIndex;
+	}
+
+	Wheel[Level][Slot] = NodeIndex;
+}
+
+void UGameplayTimerSubsystem::UnlinkNode(int32 NodeIndex)
+{
+	FTimerNode& Node = Nodes[NodeIndex];
+
+	// patch the previous link, or the slot head.
+	// Expired nodes waiting to be fired have already been detached from their slot
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+
+	} else if (Wheel[Node.Level][Node.Slot] == NodeIndex) {
+
+		Wheel[Node.Level][Node.Slot] = Node.Next;
+	}
+
+	// patch the next link
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+}
+
+const UGameplayTimerSubsystem::FTimerNode* UGameplayTimerSubsystem::FindNode(const FGameplayTimerHandle& Handle) const
+{
+	if (Nodes.IsValidIndex(Handle.Index))
+	{
+		const FTimerNode& Node = Nodes[Handle.Index];
+
+		if (Node.bActive && Node.Serial == Handle.Serial)
+		{
+			return &Node;
+		}
+	}
+
+	return nullptr;
+}
+
+void UGameplayTimerSubsystem::AdvanceTick()
+{
+	++CurrentTick;
+
+	// when a lower level wraps around, pull the next slot of the level above down into the wheel
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		const uint64 LowerBitsMask = (uint64(1) << (SlotBits * Level)) - 1;
+
+		if ((CurrentTick & LowerBitsMask) != 0)
+		{
+			break;
+		}
+
+		CascadeSlot(Level, int32((CurrentTick >> (SlotBits * Level)) & (NumSlots - 1)));
+	}
+
+	// everything in the current level 0 slot expires on this tick
+	const int32 Slot = int32(CurrentTick & (NumSlots - 1));
+
+	int32 NodeIndex = Wheel[0][Slot];
+	Wheel[0][Slot] = INDEX_NONE;
+
+	while (NodeIndex != INDEX_NONE)
+	{
+		FTimerNode& Node = Nodes[NodeIndex];
+		const int32 NextIndex = Node.Next;
+
+		Node.Prev = INDEX_NONE;
+		Node.Next = INDEX_NONE;
+
+		// queue the timer for the batched fire
+		FGameplayTimerHandle& Expired = ExpiredTimers.AddDefaulted_GetRef();
+		Expired.Index = NodeIndex;
+		Expired.Serial = Node.Serial;
+
+		NodeIndex = NextIndex;
+	}
+}
+
+void UGameplayTimerSubsystem::CascadeSlot(int32 Level, int32 Slot)
+{
+	// detach the whole slot list
+	int32 NodeIndex = Wheel[Level][Slot];
+	Wheel[Level][Slot] = INDEX_NONE;
+
+	// relink every node relative to the current tick. They'll land on a lower level
+	while (NodeIndex != INDEX_NONE)
+	{
+		const int32 NextIndex = Nodes[NodeIndex].Next;
+
+		LinkNode(NodeIndex);
+
+		NodeIndex = NextIndex;
+	}
+}
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "GameplayTimerSubsystem.generated.h"
+
+/**
+ *  Handle to a timer scheduled on the gameplay timer wheel.
+ *  Handles are generational, so a stale handle never affects a timer that reused its slot.
+ */
+struct FGameplayTimerHandle
+{
+	/** Index of the timer node in the wheel's node pool */
+	int32 Index = INDEX_NONE;
+
+	/** Generation of the node when this handle was issued */
+	uint32 Serial = 0;
+
+	/** Returns true if this handle was issued by the wheel and hasn't been cleared */
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	/** Resets the handle so it no longer refers to any timer */
+	void Invalidate() { Index = INDEX_NONE; Serial = 0; }
+};
+
+/**
+ *  Hierarchical timer wheel for short gameplay cooldowns.
+ *  - O(1) timer insertion and cancellation
+ *  - Expired callbacks are collected and fired in a single batch per frame
+ *  - Runs on dilated world time and doesn't advance while the world is paused
+ *  - Callbacks are bound weakly and timers can be cleared per owner, so pooled actors can be safely reused
+ */
+UCLASS(config=Game)
+class UGameplayTimerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Number of slot index bits per wheel level */
+	static constexpr int32 SlotBits = 6;
+
+	/** Number of slots per wheel level */
+	static constexpr int32 NumSlots = 1 << SlotBits;
+
+	/** Number of wheel levels. Each level covers NumSlots times the range of the previous one */
+	static constexpr int32 NumLevels = 4;
+
+protected:
+
+	/** Duration of a single wheel tick. Timers will never fire earlier than requested, but may fire up to one tick late */
+	UPROPERTY(Config, EditAnywhere, Category="Timers", meta = (ClampMin = 0.001, ClampMax = 0.1, Units = "s"))
+	float TickResolution = 0.01f;
+
+	/** A single scheduled timer, stored in an intrusive doubly linked list per wheel slot */
+	struct FTimerNode
+	{
+		/** Callback to run when the timer expires */
+		FTimerDelegate Delegate;
+
+		/** Object that owns this timer */
+		TWeakObjectPtr<const UObject> Owner;
+
+		/** Wheel tick at which this timer expires */
+		uint64 ExpireTick = 0;
+
+		/** Requested duration, for debugging */
+		float Duration = 0.0f;
+
+		/** Previous and next nodes in the slot list. Next doubles as the free list link */
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+
+		/** Generation counter, bumped every time the node is released */
+		uint32 Serial = 1;
+
+		/** Wheel location of this node */
+		uint8 Level = 0;
+		uint8 Slot = 0;
+
+		/** If true, this node holds a scheduled timer */
+		bool bActive = false;
+	};
+
+	/** Node pool */
+	TArray<FTimerNode> Nodes;
+
+	/** Head of the free node list */
+	int32 FreeList = INDEX_NONE;
+
+	/** Head node index for each slot of each wheel level */
+	int32 Wheel[NumLevels][NumSlots];
+
+	/** Last wheel tick that was processed */
+	uint64 CurrentTick = 0;
+
+	/** Time accumulated towards the next wheel tick */
+	float Accumulator = 0.0f;
+
+	/** Number of scheduled timers */
+	int32 NumActiveTimers = 0;
+
+	/** Timers that expired this frame and are waiting to be fired */
+	TArray<FGameplayTimerHandle> ExpiredTimers;
+
+public:
+
+	/** Schedules a callback to run after the provided delay. Any timer already referenced by the handle is cleared first */
+	void SetTimer(FGameplayTimerHandle& InOutHandle, const UObject* Owner, FTimerDelegate Delegate, float Delay);
+
+	/** Schedules a member function to run after the provided delay. Any timer already referenced by the handle is cleared first */
+	template<class UserClass>
+	void SetTimer(FGameplayTimerHandle& InOutHandle, UserClass* Owner, void (UserClass::*Function)(), float Delay)
+	{
+		SetTimer(InOutHandle, Owner, FTimerDelegate::CreateUObject(Owner, Function), Delay);
+	}
+
+	/** Cancels the timer referenced by the handle and invalidates the handle */
+	void ClearTimer(FGameplayTimerHandle& InOutHandle);
+
+	/** Cancels all timers owned by the provided object. Useful when returning actors to a pool */
+	void ClearAllTimersForOwner(const UObject* Owner);
+
+	/** Returns true if the handle references a scheduled timer */
+	bool IsTimerActive(const FGameplayTimerHandle& Handle) const;
+
+	/** Returns the time left before the timer fires, or -1 if the handle is not active */
+	float GetTimerRemaining(const FGameplayTimerHandle& Handle) const;
+
+	/** Returns the number of scheduled timers */
+	int32 GetNumActiveTimers() const { return NumActiveTimers; }
+
+	/** Logs all scheduled timers, grouped by owner */
+	void DumpTimers() const;
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	/** Advances the wheel and fires expired timers */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns a node from the free list, growing the pool if needed */
+	int32 AllocateNode();
+
+	/** Returns a node to the free list and bumps its generation */
+	void ReleaseNode(int32 NodeIndex);
+
+	/** Links a node into the wheel slot matching its expire tick */
+	void LinkNode(int32 NodeIndex);
+
+	/** Removes a node from its wheel slot */
+	void UnlinkNode(int32 NodeIndex);
+
+	/** Returns the node referenced by the handle, or nullptr if the handle is stale */
+	const FTimerNode* FindNode(const FGameplayTimerHandle& Handle) const;
+
+	/** Processes a single wheel tick, collecting expired timers */
+	void AdvanceTick();
+
+	/** Moves all nodes from a higher level slot down to their new location */
+	void CascadeSlot(int32 Level, int32 Slot);
+};
@@ -0,0 +1,283 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "HitchMonitor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NetworkCompulsory.h"
+
+namespace NetworkCompulsoryHitch
+{
+	/** Number of hitches kept in the ring buffer */
+	static constexpr int32 MaxHitches = 64;
+
+	/** Max number of distinct events recorded per frame */
+	static constexpr int32 MaxEventsPerFrame = 64;
+
+	static bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("nc.Hitch.Enabled"),
+		bEnabled,
+		TEXT("If true, frames over the game thread budget are recorded with the gameplay scopes and events that ran in them"));
+
+	static float BudgetMs = 33.3f;
+	static FAutoConsoleVariableRef CVarBudgetMs(
+		TEXT("nc.Hitch.BudgetMs"),
+		BudgetMs,
+		TEXT("Game thread budget in milliseconds. Frames that take longer, excluding idle time, are recorded as hitches"));
+
+	static float FlushIntervalSeconds = 60.0f;
+	static FAutoConsoleVariableRef CVarFlushIntervalSeconds(
+		TEXT("nc.Hitch.FlushIntervalSeconds"),
+		FlushIntervalSeconds,
+		TEXT("Seconds between writes of the latest hitch report to Saved/Hitches, when there are new hitches. 0 disables the periodic flush"));
+
+	/** Total time spent in a scope during a frame */
+	struct FScopeRecord
+	{
+		const TCHAR* Name = nullptr;
+		uint64 Cycles = 0;
+		int32 Count = 0;
+	};
+
+	/** Occurrences of an event during a frame */
+	struct FEventRecord
+	{
+		const TCHAR* Name = nullptr;
+		FName Context;
+		int32 Count = 0;
+	};
+
+	/** A frame that went over budget */
+	struct FHitchRecord
+	{
+		uint64 FrameNumber = 0;
+		double Time = 0.0;
+		float FrameMs = 0.0f;
+		float BudgetMs = 0.0f;
+		TArray<FScopeRecord> Scopes;
+		TArray<FEventRecord> Events;
+	};
+
+	/** Scopes and events of the frame in progress */
+	static TArray<FScopeRecord> FrameScopes;
+	static TArray<FEventRecord> FrameEvents;
+
+	/** Ring buffer of recorded hitches */
+	static TArray<FHitchRecord> Hitches;
+	static int32 NextHitch = 0;
+	static int32 TotalHitches = 0;
+
+	/** Platform time at the end of the last frame */
+	static double LastEndFrameTime = 0.0;
+
+	/** Platform time and hitch count of the last flush */
+	static double LastFlushTime = 0.0;
+	static int32 FlushedHitches = 0;
+
+	/** Builds the text report of the recorded hitches, oldest first */
+	static FString BuildReport()
+	{
+		FString Report = FString::Printf(TEXT("%d hitches over budget since start or last clear, showing the last %d\n"), TotalHitches, Hitches.Num());
+
+		// oldest first
+		const int32 First = Hitches.Num() < MaxHitches ? 0 : NextHitch;
+
+		for (int32 Offset = 0; Offset < Hitches.Num(); ++Offset)
+		{
+			const FHitchRecord& Hitch = Hitches[(First + Offset) % MaxHitches];
+
+			Report += FString::Printf(TEXT("Frame %llu at %.2fs: %.1f ms (budget %.1f)\n"), Hitch.FrameNumber, Hitch.Time, Hitch.FrameMs, Hitch.BudgetMs);
+
+			for (const FScopeRecord& Scope : Hitch.Scopes)
+			{
+				Report += FString::Printf(TEXT("  scope %s x%d: %.2f ms\n"), Scope.Name, Scope.Count, FPlatformTime::ToMilliseconds64(Scope.Cycles));
+			}
+
+			for (const FEventRecord& Event : Hitch.Events)
+			{
+				Report += FString::Printf(TEXT("  event %s (%s) x%d\n"), Event.Name, *Event.Context.ToString(), Event.Count);
+			}
+		}
+
+		return Report;
+	}
+
+	/** Checks the frame against the budget and starts the next one */
+	static void OnEndFrame()
+	{
+		const double Now = FPlatformTime::Seconds();
+
+		// don't count time spent waiting for the max tick rate
+		const double WorkMs = (Now - LastEndFrameTime - FApp::GetIdleTime()) * 1000.0;
+		const bool bHitch = bEnabled && LastEndFrameTime > 0.0 && WorkMs > BudgetMs;
+
+		LastEndFrameTime = Now;
+
+		if (bHitch)
+		{
+			if (Hitches.Num() < MaxHitches)
+			{
+				Hitches.AddDefaulted();
+			}
+
+			FHitchRecord& Hitch = Hitches[NextHitch];
+			NextHitch = (NextHitch + 1) % MaxHitches;
+			++TotalHitches;
+
+			Hitch.FrameNumber = GFrameCounter;
+			Hitch.Time = Now - GStartTime;
+			Hitch.FrameMs = float(WorkMs);
+			Hitch.BudgetMs = BudgetMs;
+
+			// slowest scopes first
+			Hitch.Scopes = FrameScopes;
+			Hitch.Scopes.Sort([](const FScopeRecord& A, const FScopeRecord& B) { return A.Cycles > B.Cycles; });
+
+			Hitch.Events = FrameEvents;
+		}
+
+		FrameScopes.Reset();
+		FrameEvents.Reset();
+
+		// write out new hitches periodically, so they can be collected from servers without a console
+		if (FlushIntervalSeconds > 0.0f && Now - LastFlushTime >= FlushIntervalSeconds)
+		{
+			LastFlushTime = Now;
+			FlushReport();
+
+			// don't count the file write against the next frame
+			LastEndFrameTime = FPlatformTime::Seconds();
+		}
+	}
+
+	/** Hooks the monitor into the engine loop once the engine is up */
+	static FDelayedAutoRegisterHelper RegisterEndFrame(EDelayedRegisterRunPhase::EndOfEngineInit, []
+	{
+		FCoreDelegates::OnEndFrame.AddStatic(&OnEndFrame);
+
+		// keep the hitches recorded since the last flush when the server shuts down
+		FCoreDelegates::OnPreExit.AddStatic(&FlushReport);
+	});
+
+	/** Dumps the recorded hitches */
+	static FAutoConsoleCommand DumpCommand(
+		TEXT("nc.Hitch.Dump"),
+		TEXT("Logs the frames that went over the game thread budget and writes them to Saved/Hitches"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			DumpReport();
+		})
+	);
+
+	/** Clears the recorded hitches */
+	static FAutoConsoleCommand ClearCommand(
+		TEXT("nc.Hitch.Clear"),
+		TEXT("Forgets all recorded hitches"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			ClearReport();
+		})
+	);
+
+	FScope::FScope(const TCHAR* InName)
+		: Name(InName)
+		, StartCycles(bEnabled && IsInGameThread() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	FScope::~FScope()
+	{
+		if (StartCycles == 0)
+		{
+			return;
+		}
+
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+
+		// names are literals, so compare them by address
+		FScopeRecord* Record = FrameScopes.FindByPredicate([this](const FScopeRecord& Entry) { return Entry.Name == Name; });
+
+		if (!Record)
+		{
+			Record = &FrameScopes.AddDefaulted_GetRef();
+			Record->Name = Name;
+		}
+
+		Record->Cycles += Cycles;
+		++Record->Count;
+	}
+
+	void RecordEvent(const TCHAR* Event, const UObject* Context)
+	{
+		if (!bEnabled || !IsInGameThread())
+		{
+			return;
+		}
+
+		// group events by their context class
+		const FName ContextName = Context ? Context->GetClass()->GetFName() : NAME_None;
+
+		FEventRecord* Record = FrameEvents.FindByPredicate([Event, ContextName](const FEventRecord& Entry) { return Entry.Name == Event && Entry.Context == ContextName; });
+
+		if (!Record)
+		{
+			// drop new events on runaway frames
+			if (FrameEvents.Num() >= MaxEventsPerFrame)
+			{
+				return;
+			}
+
+			Record = &FrameEvents.AddDefaulted_GetRef();
+			Record->Name = Event;
+			Record->Context = ContextName;
+		}
+
+		++Record->Count;
+	}
+
+	FString DumpReport()
+	{
+		const FString Report = BuildReport();
+
+		UE_LOG(LogNetworkCompulsory, Display, TEXT("Hitch report:\n%s"), *Report);
+
+		const FString Path = FPaths::ProjectSavedDir() / TEXT("Hitches") / FString::Printf(TEXT("Hitches-%s.log"), *FDateTime::Now().ToString());
+
+		if (!FFileHelper::SaveStringToFile(Report, *Path))
+		{
+			UE_LOG(LogNetworkCompulsory, Error, TEXT("Hitch report: could not write %s"), *Path);
+			return FString();
+		}
+
+		return Path;
+	}
+
+	void FlushReport()
+	{
+		// nothing new since the last flush
+		if (TotalHitches == FlushedHitches)
+		{
+			return;
+		}
+
+		FlushedHitches = TotalHitches;
+
+		// overwrite a single file per process, so a long running server doesn't fill the disk
+		const FString Path = FPaths::ProjectSavedDir() / TEXT("Hitches") / FString::Printf(TEXT("Hitches-Latest-%u.log"), FPlatformProcess::GetCurrentProcessId());
+
+		FFileHelper::SaveStringToFile(BuildReport(), *Path);
+	}
+
+	void ClearReport()
+	{
+		Hitches.Reset();
+		NextHitch = 0;
+		TotalHitches = 0;
+		FlushedHitches = 0;
+	}
+}
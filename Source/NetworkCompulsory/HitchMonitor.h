@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Game thread frame budget monitor.
+ *  Gameplay scopes and events are recorded for every frame. When a frame's game thread work goes over budget,
+ *  they're copied into a small ring buffer of hitch records that can be dumped on demand with nc.Hitch.Dump.
+ *  Doesn't depend on stats, trace, logging or the console, so it keeps working in shipping builds:
+ *  - New hitches are flushed to Saved/Hitches/Hitches-Latest-<pid>.log every nc.Hitch.FlushIntervalSeconds, and on exit
+ *  - On servers without a console, the cvars can be set from the [SystemSettings] section of DefaultEngine.ini
+ *  Configure it with nc.Hitch.Enabled, nc.Hitch.BudgetMs and nc.Hitch.FlushIntervalSeconds
+ */
+namespace NetworkCompulsoryHitch
+{
+	/** Times a gameplay scope in the current frame. Only game thread scopes are recorded */
+	struct FScope
+	{
+		/** Starts timing the scope */
+		NETWORKCOMPULSORY_API explicit FScope(const TCHAR* InName);
+
+		/** Adds the scope's time to the current frame */
+		NETWORKCOMPULSORY_API ~FScope();
+
+	private:
+
+		/** Name of the scope. Must be a string literal */
+		const TCHAR* Name;
+
+		/** Cycle count at the start of the scope. Zero if the scope isn't being recorded */
+		uint64 StartCycles;
+	};
+
+	/** Records a gameplay event in the current frame, such as a spawn or a damage event. Event must be a string literal */
+	NETWORKCOMPULSORY_API void RecordEvent(const TCHAR* Event, const UObject* Context = nullptr);
+
+	/** Logs the recorded hitches and writes them to Saved/Hitches. Returns the file path, or an empty string on failure */
+	NETWORKCOMPULSORY_API FString DumpReport();
+
+	/** Overwrites this process's latest report in Saved/Hitches if there were new hitches since the last flush. Doesn't log */
+	NETWORKCOMPULSORY_API void FlushReport();
+
+	/** Forgets all recorded hitches */
+	NETWORKCOMPULSORY_API void ClearReport();
+}
+
+/** Times the enclosing scope for the hitch monitor */
+#define NC_HITCH_SCOPE(Name) \
+	NetworkCompulsoryHitch::FScope ANONYMOUS_VARIABLE(HitchScope_)(TEXT(Name))
@@ -0,0 +1,404 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "LANDiscoverySubsystem.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/GameStateBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/IConsoleManager.h"
+#include "NetworkCompulsory.h"
+
+namespace LANDiscovery
+{
+	/** Identifies discovery packets */
+	static constexpr uint32 Magic = 0x4E434C44;
+
+	/** Bumped whenever the packet layout changes */
+	static constexpr uint8 Version = 1;
+
+	/** Packet types */
+	static constexpr uint8 QueryPacket = 0;
+	static constexpr uint8 BeaconPacket = 1;
+
+	/** Longest map name sent in a beacon */
+	static constexpr int32 MaxMapNameBytes = 64;
+
+	/** Largest packet read from the sockets */
+	static constexpr int32 MaxPacketSize = 128;
+
+	/** Most packets read from a socket in a single tick */
+	static constexpr int32 MaxPacketsPerTick = 64;
+
+	/** Replies slower than this are stale and ignored */
+	static constexpr uint32 MaxPingMs = 5000;
+
+	/** Weight of a new ping sample in the smoothed ping */
+	static constexpr float PingSmoothing = 0.25f;
+
+	/** Writes the header shared by all packets */
+	static void WriteHeader(FMemoryWriter& Writer, uint8 Type, uint32 Timestamp)
+	{
+		uint32 PacketMagic = Magic;
+		uint8 PacketVersion = Version;
+
+		Writer << PacketMagic << PacketVersion << Type << Timestamp;
+	}
+
+	/** Reads the packet header. Returns false if this isn't a discovery packet of the expected type */
+	static bool ReadHeader(FMemoryReader& Reader, uint8 ExpectedType, uint32& OutTimestamp)
+	{
+		uint32 PacketMagic = 0;
+		uint8 PacketVersion = 0;
+		uint8 Type = 0;
+
+		Reader << PacketMagic << PacketVersion << Type << OutTimestamp;
+
+		return !Reader.IsError() && PacketMagic == Magic && PacketVersion == Version && Type == ExpectedType;
+	}
+
+	/** Lists the LAN servers found so far, starting the browser if needed */
+	static FAutoConsoleCommandWithWorld ListCommand(
+		TEXT("nc.LAN.List"),
+		TEXT("Logs the LAN servers found by the browser. Starts browsing if it isn't already"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			ULANDiscoverySubsystem* Discovery = World && World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<ULANDiscoverySubsystem>() : nullptr;
+
+			if (!Discovery)
+			{
+				return;
+			}
+
+			if (!Discovery->IsBrowsing())
+			{
+				Discovery->StartBrowsing();
+				UE_LOG(LogNetworkCompulsory, Display, TEXT("LAN browser started, run nc.LAN.List again for results"));
+				return;
+			}
+
+			UE_LOG(LogNetworkCompulsory, Display, TEXT("LAN servers: %d"), Discovery->GetServers().Num());
+
+			for (const FLANServerInfo& Server : Discovery->GetServers())
+			{
+				UE_LOG(LogNetworkCompulsory, Display, TEXT("  %s  %s  %d/%d players  %.0fms"), *Server.Address, *Server.MapName, Server.NumPlayers, Server.MaxPlayers, Server.PingMs);
+			}
+		})
+	);
+}
+
+void ULANDiscoverySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULANDiscoverySubsystem::Tick));
+}
+
+void ULANDiscoverySubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	DestroySocket(ServerSocket);
+	DestroySocket(BrowserSocket);
+
+	Super::Deinitialize();
+}
+
+void ULANDiscoverySubsystem::StartBrowsing()
+{
+	if (BrowserSocket)
+	{
+		return;
+	}
+
+	// bind to any free port, servers reply to whichever one the query came from
+	BrowserSocket = CreateSocket(TEXT("NCLANBrowser"), 0);
+
+	if (BrowserSocket)
+	{
+		TimeSinceQuery = 0.0f;
+		SendQuery();
+	}
+}
+
+void ULANDiscoverySubsystem::StopBrowsing()
+{
+	DestroySocket(BrowserSocket);
+}
+
+bool ULANDiscoverySubsystem::Tick(float DeltaTime)
+{
+	UpdateServerSocket();
+
+	if (ServerSocket)
+	{
+		ReceiveQueries();
+	}
+
+	bool bServersChanged = false;
+
+	if (BrowserSocket)
+	{
+		bServersChanged = ReceiveBeacons();
+
+		// keep querying so the cache and pings stay fresh
+		TimeSinceQuery += DeltaTime;
+
+		if (TimeSinceQuery >= QueryInterval)
+		{
+			TimeSinceQuery = 0.0f;
+			SendQuery();
+		}
+	}
+
+	bServersChanged |= ExpireServers();
+
+	if (bServersChanged)
+	{
+		OnServersUpdated.Broadcast(Servers);
+	}
+
+	return true;
+}
+
+void ULANDiscoverySubsystem::UpdateServerSocket()
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const ENetMode NetMode = World ? World->GetNetMode() : NM_Standalone;
+	const bool bHosting = NetMode == NM_ListenServer || NetMode == NM_DedicatedServer;
+
+	if (bHosting && !ServerSocket)
+	{
+		ServerSocket = CreateSocket(TEXT("NCLANServer"), DiscoveryPort);
+
+	} else if (!bHosting && ServerSocket) {
+
+		DestroySocket(ServerSocket);
+		LastReplyTimes.Reset();
+	}
+}
+
+void ULANDiscoverySubsystem::ReceiveQueries()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> Sender = SocketSubsystem->CreateInternetAddr();
+
+	uint8 Buffer[LANDiscovery::MaxPacketSize];
+	int32 BytesRead = 0;
+
+	for (int32 PacketIndex = 0; PacketIndex < LANDiscovery::MaxPacketsPerTick && ServerSocket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *Sender); ++PacketIndex)
+	{
+		TArray<uint8> Packet(Buffer, BytesRead);
+		FMemoryReader Reader(Packet);
+
+		uint32 Timestamp = 0;
+
+		if (!LANDiscovery::ReadHeader(Reader, LANDiscovery::QueryPacket, Timestamp) || !CanReplyTo(Sender->ToString(true)))
+		{
+			continue;
+		}
+
+		// describe the session
+		const AGameStateBase* GameState = World->GetGameState();
+		const AGameModeBase* GameMode = World->GetAuthGameMode();
+
+		uint16 GamePort = (uint16)World->URL.Port;
+		uint8 NumPlayers = (uint8)FMath::Min(GameState ? GameState->PlayerArray.Num() : 0, 255);
+		uint8 MaxPlayers = (uint8)FMath::Min(GameMode && GameMode->GameSession ? GameMode->GameSession->MaxPlayers : 0, 255);
+
+		FTCHARToUTF8 MapName(*UGameplayStatics::GetCurrentLevelName(World));
+		uint8 MapNameLength = (uint8)FMath::Min(MapName.Length(), LANDiscovery::MaxMapNameBytes);
+
+		// echo the query's timestamp so the browser can measure ping
+		TArray<uint8> Beacon;
+		FMemoryWriter Writer(Beacon);
+
+		LANDiscovery::WriteHeader(Writer, LANDiscovery::BeaconPacket, Timestamp);
+		Writer << GamePort << NumPlayers << MaxPlayers << MapNameLength;
+		Writer.Serialize((void*)MapName.Get(), MapNameLength);
+
+		int32 BytesSent = 0;
+		ServerSocket->SendTo(Beacon.GetData(), Beacon.Num(), BytesSent, *Sender);
+	}
+}
+
+bool ULANDiscoverySubsystem::ReceiveBeacons()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> Sender = SocketSubsystem->CreateInternetAddr();
+
+	uint8 Buffer[LANDiscovery::MaxPacketSize];
+	int32 BytesRead = 0;
+
+	bool bServersChanged = false;
+
+	for (int32 PacketIndex = 0; PacketIndex < LANDiscovery::MaxPacketsPerTick && BrowserSocket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *Sender); ++PacketIndex)
+	{
+		TArray<uint8> Packet(Buffer, BytesRead);
+		FMemoryReader Reader(Packet);
+
+		uint32 Timestamp = 0;
+
+		if (!LANDiscovery::ReadHeader(Reader, LANDiscovery::BeaconPacket, Timestamp))
+		{
+			continue;
+		}
+
+		uint16 GamePort = 0;
+		uint8 NumPlayers = 0;
+		uint8 MaxPlayers = 0;
+		uint8 MapNameLength = 0;
+
+		Reader << GamePort << NumPlayers << MaxPlayers << MapNameLength;
+
+		if (Reader.IsError() || MapNameLength > LANDiscovery::MaxMapNameBytes || Reader.TotalSize() - Reader.Tell() < MapNameLength)
+		{
+			continue;
+		}
+
+		ANSICHAR MapNameBytes[LANDiscovery::MaxMapNameBytes];
+		Reader.Serialize(MapNameBytes, MapNameLength);
+
+		// ignore stale replies to old queries
+		const uint32 PingMs = GetTimestamp() - Timestamp;
+
+		if (PingMs > LANDiscovery::MaxPingMs)
+		{
+			continue;
+		}
+
+		const FString Address = FString::Printf(TEXT("%s:%d"), *Sender->ToString(false), GamePort);
+		const FUTF8ToTCHAR MapName(MapNameBytes, MapNameLength);
+
+		// update the cached entry, or add a new one
+		FLANServerInfo* Server = Servers.FindByPredicate([&Address](const FLANServerInfo& Info) { return Info.Address == Address; });
+
+		if (Server)
+		{
+			Server->PingMs = FMath::Lerp(Server->PingMs, (float)PingMs, LANDiscovery::PingSmoothing);
+
+		} else {
+
+			Server = &Servers.AddDefaulted_GetRef();
+			Server->Address = Address;
+			Server->PingMs = (float)PingMs;
+		}
+
+		Server->MapName = FString(MapName.Length(), MapName.Get());
+		Server->NumPlayers = NumPlayers;
+		Server->MaxPlayers = MaxPlayers;
+		Server->LastSeenTime = FPlatformTime::Seconds();
+
+		bServersChanged = true;
+	}
+
+	return bServersChanged;
+}
+
+void ULANDiscoverySubsystem::SendQuery()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> BroadcastAddress = SocketSubsystem->CreateInternetAddr();
+	BroadcastAddress->SetBroadcastAddress();
+	BroadcastAddress->SetPort(DiscoveryPort);
+
+	TArray<uint8> Query;
+	FMemoryWriter Writer(Query);
+	LANDiscovery::WriteHeader(Writer, LANDiscovery::QueryPacket, GetTimestamp());
+
+	int32 BytesSent = 0;
+	BrowserSocket->SendTo(Query.GetData(), Query.Num(), BytesSent, *BroadcastAddress);
+}
+
+bool ULANDiscoverySubsystem::ExpireServers()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	return Servers.RemoveAll([this, Now](const FLANServerInfo& Server) { return Now - Server.LastSeenTime > ServerTimeout; }) > 0;
+}
+
+bool ULANDiscoverySubsystem::CanReplyTo(const FString& Client)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// start a new rate window, forgetting clients that went quiet
+	if (Now - ReplyWindowStart >= 1.0)
+	{
+		ReplyWindowStart = Now;
+		RepliesInWindow = 0;
+
+		for (auto It = LastReplyTimes.CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value() > ServerTimeout)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	if (RepliesInWindow >= MaxRepliesPerSecond)
+	{
+		return false;
+	}
+
+	if (const double* LastReplyTime = LastReplyTimes.Find(Client))
+	{
+		if (Now - *LastReplyTime < ReplyCooldown)
+		{
+			return false;
+		}
+	}
+
+	LastReplyTimes.Add(Client, Now);
+	++RepliesInWindow;
+
+	return true;
+}
+
+FSocket* ULANDiscoverySubsystem::CreateSocket(const TCHAR* Description, int32 Port)
+{
+	FSocket* Socket = FUdpSocketBuilder(Description)
+		.AsNonBlocking()
+		.AsReusable()
+		.WithBroadcast()
+		.BoundToPort(Port)
+		.Build();
+
+	if (!Socket)
+	{
+		UE_LOG(LogNetworkCompulsory, Warning, TEXT("LAN discovery could not open a socket on port %d"), Port);
+	}
+
+	return Socket;
+}
+
+void ULANDiscoverySubsystem::DestroySocket(FSocket*& Socket)
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+uint32 ULANDiscoverySubsystem::GetTimestamp()
+{
+	// wraps every ~49 days, unsigned subtraction keeps ping deltas correct across the wrap
+	return (uint32)(FPlatformTime::Seconds() * 1000.0);
+}
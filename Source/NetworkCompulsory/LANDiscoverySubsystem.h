@@ -0,0 +1,160 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "LANDiscoverySubsystem.generated.h"
+
+class FSocket;
+class FInternetAddr;
+
+/**
+ *  A LAN server found by the browser
+ */
+USTRUCT(BlueprintType)
+struct FLANServerInfo
+{
+	GENERATED_BODY()
+
+	/** Address to travel to, as ip:port */
+	UPROPERTY(BlueprintReadOnly, Category="LAN")
+	FString Address;
+
+	/** Short name of the map the server is running */
+	UPROPERTY(BlueprintReadOnly, Category="LAN")
+	FString MapName;
+
+	/** Players currently connected */
+	UPROPERTY(BlueprintReadOnly, Category="LAN")
+	int32 NumPlayers = 0;
+
+	/** Player limit of the server's session */
+	UPROPERTY(BlueprintReadOnly, Category="LAN")
+	int32 MaxPlayers = 0;
+
+	/** Smoothed round trip time of the discovery query */
+	UPROPERTY(BlueprintReadOnly, Category="LAN")
+	float PingMs = 0.0f;
+
+	/** Time the server last answered a query */
+	double LastSeenTime = 0.0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLANServersUpdated, const TArray<FLANServerInfo>&, Servers);
+
+/**
+ *  Lightweight LAN session discovery.
+ *  While browsing, clients broadcast a small query on the discovery port at a fixed interval.
+ *  Listen and dedicated servers answer each query with a beacon carrying the map name, player count and the query's timestamp,
+ *  so the browser measures ping without opening a connection. Idle servers send nothing.
+ *  Replies are rate limited per sender and overall. Found servers are cached until they stop answering.
+ */
+UCLASS(config=Game)
+class ULANDiscoverySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** UDP port servers listen for discovery queries on */
+	UPROPERTY(Config)
+	int32 DiscoveryPort = 7787;
+
+	/** Time between browser queries */
+	UPROPERTY(Config)
+	float QueryInterval = 1.0f;
+
+	/** Time without a reply before a server is dropped from the browser */
+	UPROPERTY(Config)
+	float ServerTimeout = 5.0f;
+
+	/** Minimum time between replies to the same client */
+	UPROPERTY(Config)
+	float ReplyCooldown = 0.5f;
+
+	/** Maximum replies a server sends per second across all clients */
+	UPROPERTY(Config)
+	int32 MaxRepliesPerSecond = 32;
+
+	/** Servers found by the browser */
+	TArray<FLANServerInfo> Servers;
+
+	/** Socket the server listens for queries on. Only open while hosting */
+	FSocket* ServerSocket = nullptr;
+
+	/** Socket the browser sends queries and receives beacons on. Only open while browsing */
+	FSocket* BrowserSocket = nullptr;
+
+	/** Last reply time for each client address, used to rate limit replies */
+	TMap<FString, double> LastReplyTimes;
+
+	/** Start of the current reply rate window */
+	double ReplyWindowStart = 0.0;
+
+	/** Replies sent in the current rate window */
+	int32 RepliesInWindow = 0;
+
+	/** Time since the last browser query */
+	float TimeSinceQuery = 0.0f;
+
+	/** Ticker handle */
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+	/** Called when a server is found, updated or dropped */
+	UPROPERTY(BlueprintAssignable, Category="LAN")
+	FOnLANServersUpdated OnServersUpdated;
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Starts broadcasting discovery queries. Cached servers are kept until they time out */
+	void StartBrowsing();
+
+	/** Stops broadcasting discovery queries */
+	void StopBrowsing();
+
+	/** Returns true while the browser is running */
+	bool IsBrowsing() const { return BrowserSocket != nullptr; }
+
+	/** Returns the cached servers */
+	const TArray<FLANServerInfo>& GetServers() const { return Servers; }
+
+protected:
+
+	/** Answers queries while hosting and collects beacons while browsing */
+	bool Tick(float DeltaTime);
+
+	/** Opens or closes the server socket to match the current net mode */
+	void UpdateServerSocket();
+
+	/** Answers pending discovery queries */
+	void ReceiveQueries();
+
+	/** Reads pending beacons into the server cache. Returns true if the cache changed */
+	bool ReceiveBeacons();
+
+	/** Broadcasts a discovery query */
+	void SendQuery();
+
+	/** Drops servers that stopped answering. Returns true if any were dropped */
+	bool ExpireServers();
+
+	/** Returns true if a reply may be sent to the provided client */
+	bool CanReplyTo(const FString& Client);
+
+	/** Creates a non-blocking broadcast UDP socket bound to the provided port */
+	static FSocket* CreateSocket(const TCHAR* Description, int32 Port);
+
+	/** Closes and destroys the socket */
+	static void DestroySocket(FSocket*& Socket);
+
+	/** Returns the current time in milliseconds, truncated for the query timestamp */
+	static uint32 GetTimestamp();
+};
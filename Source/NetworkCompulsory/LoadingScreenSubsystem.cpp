@@ -0,0 +1,209 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "LoadingScreenSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/PlayerController.h"
+#include "MoviePlayer.h"
+#include "Misc/PackageName.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Images/SThrobber.h"
+#include "Widgets/Text/STextBlock.h"
+#include "NetworkCompulsory.h"
+
+void ULoadingScreenSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &ULoadingScreenSubsystem::OnPreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ULoadingScreenSubsystem::OnPostLoadMap);
+}
+
+void ULoadingScreenSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMapWithContext.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void ULoadingScreenSubsystem::OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName)
+{
+	// ignore map loads for other game instances, e.g. other PIE clients
+	if (WorldContext.OwningGameInstance != GetGameInstance())
+	{
+		return;
+	}
+
+	LoadingMapName = FPackageName::GetShortName(MapName);
+	LoadStartTime = FPlatformTime::Seconds();
+	MapLoadedTime = 0.0;
+	PreloadCompleteTime = 0.0;
+	bWaitingForInteractive = false;
+
+	// seamless travel keeps the transition map running, so there's nothing to cover
+	const UWorld* World = GetGameInstance()->GetWorld();
+
+	if (!IsRunningDedicatedServer() && !(World && World->IsInSeamlessTravel()))
+	{
+		ShowLoadingScreen(LoadingMapName);
+	}
+
+	StartPreloads(LoadingMapName);
+}
+
+void ULoadingScreenSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	// only track maps we saw start loading
+	if (LoadStartTime <= 0.0 || !LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	MapLoadedTime = FPlatformTime::Seconds();
+	bWaitingForInteractive = true;
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULoadingScreenSubsystem::Tick));
+	}
+}
+
+void ULoadingScreenSubsystem::OnPreloadComplete()
+{
+	PreloadCompleteTime = FPlatformTime::Seconds();
+}
+
+bool ULoadingScreenSubsystem::Tick(float DeltaTime)
+{
+	if (!bWaitingForInteractive)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// give up if the map never becomes playable, e.g. when sitting in the main menu
+	if (Now - MapLoadedTime > InteractiveTimeout)
+	{
+		UE_LOG(LogNetworkCompulsory, Log, TEXT("%s did not become interactive within %.0fs"), *LoadingMapName, InteractiveTimeout);
+
+		bWaitingForInteractive = false;
+		TickerHandle.Reset();
+		return false;
+	}
+
+	const bool bPreloadsDone = !PreloadHandle.IsValid() || PreloadHandle->HasLoadCompleted();
+
+	if (!bPreloadsDone || !IsInteractive(GetGameInstance()->GetWorld()))
+	{
+		return true;
+	}
+
+	const double PreloadTime = (PreloadCompleteTime > 0.0 ? PreloadCompleteTime : Now) - LoadStartTime;
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Time to interactive for %s: %.2fs (map load %.2fs, preloads %.2fs)"),
+		*LoadingMapName, Now - LoadStartTime, MapLoadedTime - LoadStartTime, PreloadTime);
+
+	bWaitingForInteractive = false;
+	TickerHandle.Reset();
+	return false;
+}
+
+void ULoadingScreenSubsystem::ShowLoadingScreen(const FString& MapName)
+{
+	if (!IsMoviePlayerEnabled() || GetMoviePlayer()->IsMovieCurrentlyPlaying())
+	{
+		return;
+	}
+
+	// simple Slate widget, so it's safe to tick on the loading thread without touching UObjects
+	FLoadingScreenAttributes LoadingScreen;
+	LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
+	LoadingScreen.MinimumLoadingScreenDisplayTime = MinimumDisplayTime;
+	LoadingScreen.WidgetLoadingScreen =
+		SNew(SBorder)
+		.BorderImage(FCoreStyle::Get().GetBrush("BlackBrush"))
+		.HAlign(HAlign_Right)
+		.VAlign(VAlign_Bottom)
+		.Padding(FMargin(48.0f))
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(FMargin(0.0f, 0.0f, 16.0f, 0.0f))
+			[
+				SNew(STextBlock)
+				.Text(FText::Format(NSLOCTEXT("NetworkCompulsory", "LoadingMap", "Loading {0}"), FText::FromString(MapName)))
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SThrobber)
+			]
+		];
+
+	GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
+	GetMoviePlayer()->PlayMovie();
+}
+
+void ULoadingScreenSubsystem::StartPreloads(const FString& MapName)
+{
+	TArray<FSoftObjectPath> Assets = CommonPreloads;
+
+	if (const FMapPreloadList* MapList = MapPreloads.FindByPredicate([&MapName](const FMapPreloadList& List) { return List.Map == FName(MapName); }))
+	{
+		Assets.Append(MapList->Assets);
+	}
+
+	// request the new assets before releasing the old ones, so anything shared stays loaded
+	TSharedPtr<FStreamableHandle> PreviousHandle = PreloadHandle;
+	PreloadHandle.Reset();
+
+	if (Assets.Num() > 0)
+	{
+		PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Assets,
+			FStreamableDelegate::CreateUObject(this, &ULoadingScreenSubsystem::OnPreloadComplete),
+			FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (PreviousHandle.IsValid())
+	{
+		PreviousHandle->ReleaseHandle();
+	}
+}
+
+bool ULoadingScreenSubsystem::IsInteractive(const UWorld* World) const
+{
+	if (!World || !World->HasBegunPlay())
+	{
+		return false;
+	}
+
+	if (IsRunningDedicatedServer())
+	{
+		return true;
+	}
+
+	const APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController(World);
+
+	return PC && PC->GetPawn();
+}
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "UObject/SoftObjectPath.h"
+#include "LoadingScreenSubsystem.generated.h"
+
+struct FStreamableHandle;
+struct FWorldContext;
+
+/**
+ *  Gameplay assets to preload for a single map
+ */
+USTRUCT()
+struct FMapPreloadList
+{
+	GENERATED_BODY()
+
+	/** Short name of the map */
+	UPROPERTY(Config)
+	FName Map;
+
+	/** Classes and assets spawned during play on this map */
+	UPROPERTY(Config)
+	TArray<FSoftObjectPath> Assets;
+};
+
+/**
+ *  Session start loading pipeline.
+ *  Shows a loading screen on the Slate loading thread while a map loads, so hosting and joining don't freeze the window.
+ *  Seamless travel keeps the transition map running instead, so it skips the loading screen.
+ *  Preloads the map's gameplay classes asynchronously as soon as the load starts and keeps them resident until the next map,
+ *  so the first character, enemy, projectile or VFX spawn doesn't hitch.
+ *  Logs the time from the start of the load until the first local player controls a pawn and the preloads are done.
+ */
+UCLASS(config=Game)
+class ULoadingScreenSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Minimum time the loading screen stays up, to avoid flashing it on fast loads */
+	UPROPERTY(Config)
+	float MinimumDisplayTime = 0.5f;
+
+	/** Time after the map loads to wait for it to become interactive before giving up on the metric */
+	UPROPERTY(Config)
+	float InteractiveTimeout = 60.0f;
+
+	/** Assets preloaded for every map */
+	UPROPERTY(Config)
+	TArray<FSoftObjectPath> CommonPreloads;
+
+	/** Assets preloaded for specific maps */
+	UPROPERTY(Config)
+	TArray<FMapPreloadList> MapPreloads;
+
+	/** Handle keeping the current map's preloads resident */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** Short name of the map being loaded */
+	FString LoadingMapName;
+
+	/** Time the current load started */
+	double LoadStartTime = 0.0;
+
+	/** Time the map finished loading. Zero while it's still loading */
+	double MapLoadedTime = 0.0;
+
+	/** Time the preloads completed. Zero while they're still loading */
+	double PreloadCompleteTime = 0.0;
+
+	/** If true, we're waiting for the loaded map to become interactive */
+	bool bWaitingForInteractive = false;
+
+	/** Ticker handle */
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Starts the loading screen and the preloads for the map, if it's loading into our game instance */
+	void OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName);
+
+	/** Starts waiting for the loaded map to become interactive */
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/** Records the preload completion time */
+	void OnPreloadComplete();
+
+	/** Logs the time to interactive once the map is playable */
+	bool Tick(float DeltaTime);
+
+	/** Sets up and plays the loading screen for the map */
+	void ShowLoadingScreen(const FString& MapName);
+
+	/** Starts the async preloads for the map, replacing the previous map's */
+	void StartPreloads(const FString& MapName);
+
+	/** Returns true once the first local player controls a pawn, or the world has begun play on a dedicated server */
+	bool IsInteractive(const UWorld* World) const;
+};
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MatchReplayNetDriver.h"
+
+void UMatchReplayNetDriver::TickFlush(float DeltaSeconds)
+{
+	// playback work isn't part of the recording budget
+	if (!IsRecording())
+	{
+		Super::TickFlush(DeltaSeconds);
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	Super::TickFlush(DeltaSeconds);
+
+	RecordSeconds += FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+}
+
+double UMatchReplayNetDriver::ConsumeRecordTime()
+{
+	const double Seconds = RecordSeconds;
+	RecordSeconds = 0.0;
+
+	return Seconds;
+}
@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DemoNetDriver.h"
+#include "MatchReplayNetDriver.generated.h"
+
+/**
+ *  Demo net driver used for match recording.
+ *  Measures the game thread time spent recording so the replay subsystem can keep it within budget
+ */
+UCLASS(transient, config=Engine)
+class UMatchReplayNetDriver : public UDemoNetDriver
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time spent recording since the last call to ConsumeRecordTime */
+	double RecordSeconds = 0.0;
+
+public:
+
+	/** Times the recording work done this frame */
+	virtual void TickFlush(float DeltaSeconds) override;
+
+	/** Returns the time spent recording since the last call and resets it */
+	double ConsumeRecordTime();
+};
@@ -0,0 +1,612 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MatchReplaySubsystem.h"
+#include "MatchReplayNetDriver.h"
+#include "MyGameInstance.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "NetworkCompulsory.h"
+
+namespace MatchReplay
+{
+	/** Identifies compressed replay files */
+	static constexpr uint32 Magic = 0x4E435250;
+
+	/** Bumped whenever the compressed layout changes */
+	static constexpr uint32 Version = 1;
+
+	/** Size of each independently compressed block */
+	static constexpr int32 ChunkSize = 1024 * 1024;
+
+	/** Replay streamer used for recording and playback. Writes a single file per replay to Saved/Demos */
+	static const TCHAR* StreamerOption = TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming");
+
+	/** Returns the directory replays are saved to */
+	static FString GetDemoDir()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("Demos");
+	}
+
+	/** Returns the path of the uncompressed replay written by the streamer */
+	static FString GetReplayPath(const FString& Name)
+	{
+		return GetDemoDir() / Name + TEXT(".replay");
+	}
+
+	/** Returns the path of the compressed replay */
+	static FString GetCompressedPath(const FString& Name)
+	{
+		return GetDemoDir() / Name + TEXT(".ncreplay");
+	}
+
+	/** Returns the path the compressed replay is written to before it's complete */
+	static FString GetCompressingPath(const FString& Name)
+	{
+		return GetCompressedPath(Name) + TEXT(".tmp");
+	}
+
+	/**
+	 *  Compresses a finished replay chunk by chunk and deletes the original. Safe to call off the game thread.
+	 *  Reading is limited to MaxMBps so the pass doesn't compete with the game for disk and CPU. Zero removes the limit
+	 */
+	static bool CompressReplay(const FString& Name, float MaxMBps)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetReplayPath(Name)));
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*GetCompressingPath(Name)));
+
+		if (!Reader || !Writer)
+		{
+			return false;
+		}
+
+		uint32 FileMagic = Magic;
+		uint32 FileVersion = Version;
+		*Writer << FileMagic << FileVersion;
+
+		TArray<uint8> RawChunk;
+		TArray<uint8> CompressedChunk;
+		RawChunk.SetNumUninitialized(ChunkSize);
+		CompressedChunk.SetNumUninitialized(FCompression::CompressMemoryBound(NAME_Oodle, ChunkSize));
+
+		const int64 TotalSize = Reader->TotalSize();
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int64 Offset = 0; Offset < TotalSize; Offset += ChunkSize)
+		{
+			int32 RawSize = (int32)FMath::Min<int64>(ChunkSize, TotalSize - Offset);
+			Reader->Serialize(RawChunk.GetData(), RawSize);
+
+			int32 CompressedSize = CompressedChunk.Num();
+
+			if (!FCompression::CompressMemory(NAME_Oodle, CompressedChunk.GetData(), CompressedSize, RawChunk.GetData(), RawSize))
+			{
+				Writer->Close();
+				IFileManager::Get().Delete(*GetCompressingPath(Name));
+				return false;
+			}
+
+			*Writer << RawSize << CompressedSize;
+			Writer->Serialize(CompressedChunk.GetData(), CompressedSize);
+
+			// wait out the rest of this chunk's time slice if we're ahead of the rate limit
+			if (MaxMBps > 0.0f)
+			{
+				const double TargetSeconds = (Offset + RawSize) / (MaxMBps * 1024.0 * 1024.0);
+				const double AheadSeconds = TargetSeconds - (FPlatformTime::Seconds() - StartTime);
+
+				if (AheadSeconds > 0.0)
+				{
+					FPlatformProcess::Sleep(float(AheadSeconds));
+				}
+			}
+		}
+
+		const int64 CompressedBytes = Writer->TotalSize();
+		const bool bSucceeded = !Reader->IsError() && Writer->Close();
+
+		Reader.Reset();
+
+		Writer.Reset();
+
+		// only give the file its final name once it's complete, so an interrupted pass never leaves a truncated replay behind
+		if (!bSucceeded || !IFileManager::Get().Move(*GetCompressedPath(Name), *GetCompressingPath(Name)))
+		{
+			IFileManager::Get().Delete(*GetCompressingPath(Name));
+			return false;
+		}
+
+		IFileManager::Get().Delete(*GetReplayPath(Name));
+
+		UE_LOG(LogNetworkCompulsory, Display, TEXT("Compressed replay %s: %.1f MB to %.1f MB"), *Name, TotalSize / (1024.0 * 1024.0), CompressedBytes / (1024.0 * 1024.0));
+		return true;
+	}
+
+	/** Restores the streamer's replay file from a compressed replay. Safe to call off the game thread */
+	static bool DecompressReplay(const FString& Name)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetCompressedPath(Name)));
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*GetReplayPath(Name)));
+
+		if (!Reader || !Writer)
+		{
+			return false;
+		}
+
+		uint32 FileMagic = 0;
+		uint32 FileVersion = 0;
+		*Reader << FileMagic << FileVersion;
+
+		bool bSucceeded = !Reader->IsError() && FileMagic == Magic && FileVersion == Version;
+
+		TArray<uint8> RawChunk;
+		TArray<uint8> CompressedChunk;
+		RawChunk.SetNumUninitialized(ChunkSize);
+		CompressedChunk.SetNumUninitialized(FCompression::CompressMemoryBound(NAME_Oodle, ChunkSize));
+
+		while (bSucceeded && !Reader->AtEnd())
+		{
+			int32 RawSize = 0;
+			int32 CompressedSize = 0;
+			*Reader << RawSize << CompressedSize;
+
+			// reject corrupt chunk headers before touching the buffers
+			if (Reader->IsError() || RawSize <= 0 || RawSize > ChunkSize || CompressedSize <= 0 || CompressedSize > CompressedChunk.Num())
+			{
+				bSucceeded = false;
+				break;
+			}
+
+			Reader->Serialize(CompressedChunk.GetData(), CompressedSize);
+
+			bSucceeded = !Reader->IsError() && FCompression::UncompressMemory(NAME_Oodle, RawChunk.GetData(), RawSize, CompressedChunk.GetData(), CompressedSize);
+
+			if (bSucceeded)
+			{
+				Writer->Serialize(RawChunk.GetData(), RawSize);
+			}
+		}
+
+		bSucceeded &= Writer->Close();
+
+		if (!bSucceeded)
+		{
+			IFileManager::Get().Delete(*GetReplayPath(Name));
+		}
+
+		return bSucceeded;
+	}
+
+	/**
+	 *  Deletes the oldest match replays beyond the provided count, counting both compressed and uncompressed ones.
+	 *  Also deletes uncompressed copies left behind by playback and unfinished compressions. Replays in use are left alone
+	 */
+	static void PruneReplays(int32 MaxReplays, const TSet<FString>& InUse)
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(GetDemoDir() / TEXT("Match_*")), true, false);
+
+		TSet<FString> Names;
+
+		for (const FString& File : Files)
+		{
+			const FString Name = File.Left(File.Find(TEXT(".")));
+
+			if (InUse.Contains(Name))
+			{
+				continue;
+			}
+
+			if (File.EndsWith(TEXT(".tmp")))
+			{
+				IFileManager::Get().Delete(*(GetDemoDir() / File));
+				continue;
+			}
+
+			Names.Add(Name);
+		}
+
+		TArray<FString> SortedNames = Names.Array();
+
+		// names end with a sortable timestamp, so the oldest sort first
+		SortedNames.Sort([](const FString& A, const FString& B) { return A.Right(15) < B.Right(15); });
+
+		for (int32 Index = 0; Index < SortedNames.Num(); ++Index)
+		{
+			const FString& Name = SortedNames[Index];
+			const bool bCompressed = IFileManager::Get().FileExists(*GetCompressedPath(Name));
+
+			// the uncompressed file is only worth keeping if it's the only copy we have
+			if (bCompressed || Index < SortedNames.Num() - MaxReplays)
+			{
+				IFileManager::Get().Delete(*GetReplayPath(Name));
+			}
+
+			if (Index < SortedNames.Num() - MaxReplays)
+			{
+				IFileManager::Get().Delete(*GetCompressedPath(Name));
+			}
+		}
+	}
+
+	/** Returns the match replay subsystem for the world */
+	static UMatchReplaySubsystem* GetSubsystem(UWorld* World)
+	{
+		return World && World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UMatchReplaySubsystem>() : nullptr;
+	}
+
+	/** Starts or stops recording */
+	static FAutoConsoleCommandWithWorldAndArgs RecordCommand(
+		TEXT("nc.Replay.Record"),
+		TEXT("Starts recording the current match on the server. Pass stop to end the recording"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UMatchReplaySubsystem* Replays = GetSubsystem(World))
+			{
+				if (Args.Num() > 0 && Args[0] == TEXT("stop"))
+				{
+					Replays->StopRecording();
+
+				} else {
+
+					Replays->StartRecording();
+				}
+			}
+		})
+	);
+
+	/** Plays a recorded match */
+	static FAutoConsoleCommandWithWorldAndArgs PlayCommand(
+		TEXT("nc.Replay.Play"),
+		TEXT("Plays back the named match replay from Saved/Demos"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMatchReplaySubsystem* Replays = GetSubsystem(World);
+
+			if (Replays && Args.Num() > 0)
+			{
+				Replays->PlayReplay(Args[0]);
+			}
+		})
+	);
+
+	/** Lists the recorded matches */
+	static FAutoConsoleCommandWithWorld ListCommand(
+		TEXT("nc.Replay.List"),
+		TEXT("Lists the match replays in Saved/Demos"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UMatchReplaySubsystem* Replays = GetSubsystem(World))
+			{
+				Replays->ListReplays();
+			}
+		})
+	);
+}
+
+void UMatchReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &UMatchReplaySubsystem::OnPreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMatchReplaySubsystem::OnPostLoadMap);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMatchReplaySubsystem::Tick));
+
+	// clean up anything the last session left behind
+	bPrunePending = true;
+}
+
+void UMatchReplaySubsystem::Deinitialize()
+{
+	StopRecording();
+
+	FCoreUObjectDelegates::PreLoadMapWithContext.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	Super::Deinitialize();
+}
+
+void UMatchReplaySubsystem::StartRecording()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	// only servers record, and only one match at a time
+	if (IsRecording() || !World || World->IsPlayingReplay() || World->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	RecordingName = FString::Printf(TEXT("Match_%s_%s"), *UGameplayStatics::GetCurrentLevelName(World), *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")));
+
+	// start at the full rate, the budget controller backs off as needed
+	if (IConsoleVariable* RecordHzVar = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz")))
+	{
+		OriginalRecordHz = RecordHzVar->GetFloat();
+	}
+
+	RecordHz = MaxRecordHz;
+	ApplyRecordHz(RecordHz);
+
+	SampleRecordSeconds = SampleWallSeconds = 0.0;
+	TotalRecordSeconds = TotalWallSeconds = 0.0;
+	SizeSamples.Reset();
+
+	GetGameInstance()->StartRecordingReplay(RecordingName, RecordingName, { MatchReplay::StreamerOption });
+
+	// the rate controller needs the timed driver. PIE reads the editor engine's driver definitions, so both need it
+	if (World->GetDemoNetDriver() && !Cast<UMatchReplayNetDriver>(World->GetDemoNetDriver()))
+	{
+		UE_LOG(LogNetworkCompulsory, Warning, TEXT("Recording %s with %s instead of UMatchReplayNetDriver, so the recording time can't be budgeted. Check the DemoNetDriver definitions in DefaultEngine.ini"),
+			*RecordingName, *World->GetDemoNetDriver()->GetClass()->GetName());
+	}
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Recording match replay %s"), *RecordingName);
+}
+
+void UMatchReplaySubsystem::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	GetGameInstance()->StopRecordingReplay();
+
+	const double AverageOverhead = TotalWallSeconds > 0.0 ? 100.0 * TotalRecordSeconds / TotalWallSeconds : 0.0;
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Stopped recording %s: %.0fs, %.2f%% of frame time spent recording, final rate %.1f Hz"), *RecordingName, TotalWallSeconds, AverageOverhead, RecordHz);
+
+	if (bCompressReplays)
+	{
+		PendingCompressions.Emplace(RecordingName, FPlatformTime::Seconds() + CompressDelay);
+
+	} else {
+
+		bPrunePending = true;
+	}
+
+	ApplyRecordHz(OriginalRecordHz);
+	RecordingName.Reset();
+}
+
+void UMatchReplaySubsystem::PlayReplay(const FString& Name)
+{
+	// keep the pruning pass away from the replay we're about to play
+	PlaybackName = Name;
+
+	// the raw replay is only kept until it's compressed
+	if (IFileManager::Get().FileExists(*MatchReplay::GetReplayPath(Name)))
+	{
+		PlayUncompressedReplay(Name);
+		return;
+	}
+
+	if (!IFileManager::Get().FileExists(*MatchReplay::GetCompressedPath(Name)))
+	{
+		UE_LOG(LogNetworkCompulsory, Warning, TEXT("Replay %s not found in %s"), *Name, *MatchReplay::GetDemoDir());
+		return;
+	}
+
+	// decompress in the background, then start playback on the game thread
+	TWeakObjectPtr<UMatchReplaySubsystem> WeakThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Name]()
+	{
+		const bool bDecompressed = MatchReplay::DecompressReplay(Name);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Name, bDecompressed]()
+		{
+			UMatchReplaySubsystem* Replays = WeakThis.Get();
+
+			if (!Replays)
+			{
+				return;
+			}
+
+			if (bDecompressed)
+			{
+				Replays->PlayUncompressedReplay(Name);
+
+			} else {
+
+				UE_LOG(LogNetworkCompulsory, Warning, TEXT("Could not decompress replay %s"), *Name);
+			}
+		});
+	});
+}
+
+void UMatchReplaySubsystem::ListReplays() const
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(MatchReplay::GetDemoDir() / TEXT("Match_*")), true, false);
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Match replays: %d"), Files.Num());
+
+	for (const FString& File : Files)
+	{
+		const int64 Size = IFileManager::Get().FileSize(*(MatchReplay::GetDemoDir() / File));
+		UE_LOG(LogNetworkCompulsory, Display, TEXT("  %s  %.1f MB"), *File, Size / (1024.0 * 1024.0));
+	}
+}
+
+bool UMatchReplaySubsystem::ShouldRecord() const
+{
+	const UMyGameInstance* GameInstance = Cast<UMyGameInstance>(GetGameInstance());
+
+	return (GameInstance && GameInstance->ShouldRecordMatches()) || FParse::Param(FCommandLine::Get(), TEXT("NCRecord"));
+}
+
+void UMatchReplaySubsystem::OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName)
+{
+	// ignore map loads for other game instances, e.g. other PIE clients
+	if (WorldContext.OwningGameInstance != GetGameInstance())
+	{
+		return;
+	}
+
+	// each map is recorded as its own replay
+	StopRecording();
+}
+
+void UMatchReplaySubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance() || LoadedWorld->IsPlayingReplay())
+	{
+		return;
+	}
+
+	const ENetMode NetMode = LoadedWorld->GetNetMode();
+
+	if ((NetMode == NM_ListenServer || NetMode == NM_DedicatedServer) && ShouldRecord())
+	{
+		StartRecording();
+	}
+}
+
+bool UMatchReplaySubsystem::Tick(float DeltaTime)
+{
+	if (IsRecording())
+	{
+		const UWorld* World = GetGameInstance()->GetWorld();
+
+		if (UMatchReplayNetDriver* DemoDriver = World ? Cast<UMatchReplayNetDriver>(World->GetDemoNetDriver()) : nullptr)
+		{
+			SampleRecordSeconds += DemoDriver->ConsumeRecordTime();
+		}
+
+		SampleWallSeconds += DeltaTime;
+
+		if (SampleWallSeconds >= 1.0)
+		{
+			UpdateRecordRate();
+		}
+	}
+
+	// compress and prune one pass at a time, so finished replays never pile up competing for the disk
+	if (BackgroundTask.IsValid() && !BackgroundTask.IsReady())
+	{
+		return true;
+	}
+
+	// compress finished replays once the streamer is done with them
+	const double Now = FPlatformTime::Seconds();
+	const int32 DueIndex = PendingCompressions.IndexOfByPredicate([Now](const TPair<FString, double>& Pending) { return Now >= Pending.Value; });
+
+	if (DueIndex == INDEX_NONE && !bPrunePending)
+	{
+		return true;
+	}
+
+	FString Name;
+
+	if (DueIndex != INDEX_NONE)
+	{
+		Name = PendingCompressions[DueIndex].Key;
+		PendingCompressions.RemoveAt(DueIndex);
+	}
+
+	bPrunePending = false;
+
+	const TSet<FString> InUse = GetReplaysInUse();
+	const int32 KeepReplays = MaxReplays;
+	const float MaxMBps = MaxCompressMBps;
+
+	// runs on its own thread, since the rate limit sleeps between chunks
+	BackgroundTask = Async(EAsyncExecution::Thread, [Name, InUse, KeepReplays, MaxMBps]()
+	{
+		if (!Name.IsEmpty() && !MatchReplay::CompressReplay(Name, MaxMBps))
+		{
+			UE_LOG(LogNetworkCompulsory, Warning, TEXT("Could not compress replay %s, keeping the uncompressed file"), *Name);
+		}
+
+		MatchReplay::PruneReplays(KeepReplays, InUse);
+	});
+
+	return true;
+}
+
+void UMatchReplaySubsystem::UpdateRecordRate()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double OverheadPercent = 100.0 * SampleRecordSeconds / SampleWallSeconds;
+
+	TotalRecordSeconds += SampleRecordSeconds;
+	TotalWallSeconds += SampleWallSeconds;
+	SampleRecordSeconds = SampleWallSeconds = 0.0;
+
+	// average the write rate over the window, since the streamer flushes in bursts
+	const int64 FileSize = FMath::Max<int64>(IFileManager::Get().FileSize(*MatchReplay::GetReplayPath(RecordingName)), 0);
+	SizeSamples.Emplace(Now, FileSize);
+
+	while (SizeSamples.Num() > 2 && Now - SizeSamples[1].Key >= BandwidthWindow)
+	{
+		SizeSamples.RemoveAt(0);
+	}
+
+	const double WindowSeconds = Now - SizeSamples[0].Key;
+	const double WriteKBps = WindowSeconds > 0.0 ? (FileSize - SizeSamples[0].Value) / 1024.0 / WindowSeconds : 0.0;
+
+	// back off quickly when over budget, and recover slowly once well under it
+	float NewRecordHz = RecordHz;
+
+	if (OverheadPercent > TargetOverheadPercent || WriteKBps > MaxWriteKBps)
+	{
+		NewRecordHz = FMath::Max(MinRecordHz, RecordHz * 0.75f);
+
+	} else if (OverheadPercent < TargetOverheadPercent * 0.5 && WriteKBps < MaxWriteKBps * 0.5) {
+
+		NewRecordHz = FMath::Min(MaxRecordHz, RecordHz + 1.0f);
+	}
+
+	if (NewRecordHz != RecordHz)
+	{
+		UE_LOG(LogNetworkCompulsory, Verbose, TEXT("Replay record rate %.1f -> %.1f Hz (%.2f%% frame time, %.0f KB/s)"), RecordHz, NewRecordHz, OverheadPercent, WriteKBps);
+
+		RecordHz = NewRecordHz;
+		ApplyRecordHz(RecordHz);
+	}
+}
+
+void UMatchReplaySubsystem::ApplyRecordHz(float Hz) const
+{
+	if (IConsoleVariable* RecordHzVar = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz")))
+	{
+		RecordHzVar->Set(Hz, ECVF_SetByCode);
+	}
+}
+
+void UMatchReplaySubsystem::PlayUncompressedReplay(const FString& Name)
+{
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Playing match replay %s"), *Name);
+
+	GetGameInstance()->PlayReplay(Name, nullptr, { MatchReplay::StreamerOption });
+}
+
+TSet<FString> UMatchReplaySubsystem::GetReplaysInUse() const
+{
+	TSet<FString> InUse;
+
+	if (IsRecording())
+	{
+		InUse.Add(RecordingName);
+	}
+
+	if (!PlaybackName.IsEmpty())
+	{
+		InUse.Add(PlaybackName);
+	}
+
+	for (const TPair<FString, double>& Pending : PendingCompressions)
+	{
+		InUse.Add(Pending.Key);
+	}
+
+	return InUse;
+}
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "MatchReplaySubsystem.generated.h"
+
+struct FWorldContext;
+
+/**
+ *  Server side match recording.
+ *  Records every map a listen or dedicated server hosts through the match replay demo net driver,
+ *  when UMyGameInstance::SetRecordMatches is enabled or the game is launched with -NCRecord.
+ *  The record rate is adjusted every second to keep the recording time under a percentage of the frame
+ *  and the replay's disk writes under a bandwidth limit.
+ *  Finished replays are compressed one at a time in the background, at a limited rate, into .ncreplay files in Saved/Demos.
+ *  Only the newest few replays are kept, compressed or not, and uncompressed playback copies are cleaned up.
+ *  Play them back with nc.Replay.Play, which decompresses them first if needed
+ */
+UCLASS(config=Game)
+class UMatchReplaySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Share of the frame time the recording may use */
+	UPROPERTY(Config)
+	float TargetOverheadPercent = 2.0f;
+
+	/** Average disk write bandwidth the recording may use */
+	UPROPERTY(Config)
+	float MaxWriteKBps = 256.0f;
+
+	/** Record rate used when within budget */
+	UPROPERTY(Config)
+	float MaxRecordHz = 8.0f;
+
+	/** Lowest record rate the budget controller may drop to */
+	UPROPERTY(Config)
+	float MinRecordHz = 2.0f;
+
+	/** Time the write bandwidth is averaged over. Replays are flushed to disk in chunks, so this should span several */
+	UPROPERTY(Config)
+	float BandwidthWindow = 30.0f;
+
+	/** If true, finished replays are compressed */
+	UPROPERTY(Config)
+	bool bCompressReplays = true;
+
+	/** Time to let the replay streamer finish writing before compressing */
+	UPROPERTY(Config)
+	float CompressDelay = 5.0f;
+
+	/** Read rate the compression pass is limited to, in MB/s. Zero removes the limit */
+	UPROPERTY(Config)
+	float MaxCompressMBps = 16.0f;
+
+	/** Number of match replays kept on disk */
+	UPROPERTY(Config)
+	int32 MaxReplays = 10;
+
+	/** Name of the replay being recorded. Empty when not recording */
+	FString RecordingName;
+
+	/** Record rate before recording started, restored when it stops */
+	float OriginalRecordHz = 0.0f;
+
+	/** Current record rate */
+	float RecordHz = 0.0f;
+
+	/** Recording and wall time accumulated since the last budget update */
+	double SampleRecordSeconds = 0.0;
+	double SampleWallSeconds = 0.0;
+
+	/** Recording and wall time accumulated over the whole recording */
+	double TotalRecordSeconds = 0.0;
+	double TotalWallSeconds = 0.0;
+
+	/** Replay file size samples over the bandwidth window, as time and bytes */
+	TArray<TPair<double, int64>> SizeSamples;
+
+	/** Finished replays waiting to be compressed, with the time they're due */
+	TArray<TPair<FString, double>> PendingCompressions;
+
+	/** Name of the last replay played back, so its uncompressed copy isn't pruned while it plays */
+	FString PlaybackName;
+
+	/** If true, old replays should be pruned even if there's nothing to compress */
+	bool bPrunePending = false;
+
+	/** Running compression and pruning pass */
+	TFuture<void> BackgroundTask;
+
+	/** Ticker handle */
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Starts recording the current map. Server only */
+	void StartRecording();
+
+	/** Stops the current recording and queues it for compression */
+	void StopRecording();
+
+	/** Returns true while a match is being recorded */
+	bool IsRecording() const { return !RecordingName.IsEmpty(); }
+
+	/** Plays back a recorded match, decompressing it first if needed */
+	void PlayReplay(const FString& Name);
+
+	/** Logs the recorded matches on disk */
+	void ListReplays() const;
+
+protected:
+
+	/** Returns true if matches should be recorded */
+	bool ShouldRecord() const;
+
+	/** Stops recording before our game instance changes maps */
+	void OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName);
+
+	/** Starts recording hosted maps */
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/** Measures the recording cost and runs pending compressions */
+	bool Tick(float DeltaTime);
+
+	/** Adjusts the record rate to keep the recording within its frame time and bandwidth budgets */
+	void UpdateRecordRate();
+
+	/** Applies the record rate to the demo net driver */
+	void ApplyRecordHz(float Hz) const;
+
+	/** Starts playback of an uncompressed replay */
+	void PlayUncompressedReplay(const FString& Name);
+
+	/** Returns the names of the replays that are being recorded, played or waiting for compression */
+	TSet<FString> GetReplaysInUse() const;
+};
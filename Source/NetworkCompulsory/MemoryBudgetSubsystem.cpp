@@ -0,0 +1,249 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MemoryBudgetSubsystem.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/UObjectIterator.h"
+#include "Blueprint/UserWidget.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Projectile.h"
+#include "CombatEnemy.h"
+#include "CombatEnemySpawner.h"
+#include "GameplayTimerSubsystem.h"
+#include "NetworkCompulsory.h"
+
+LLM_DEFINE_TAG(NCProjectiles);
+LLM_DEFINE_TAG(NCEnemies);
+LLM_DEFINE_TAG(NCSpawners);
+LLM_DEFINE_TAG(NCUI);
+LLM_DEFINE_TAG(NCVFX);
+LLM_DEFINE_TAG(NCTimers);
+
+namespace MemoryBudget
+{
+	/** Logs the per-subsystem memory table */
+	static FAutoConsoleCommandWithWorld ReportCommand(
+		TEXT("nc.Memory.Report"),
+		TEXT("Logs current and peak memory and live object counts for each gameplay subsystem"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UMemoryBudgetSubsystem* Memory = World ? World->GetSubsystem<UMemoryBudgetSubsystem>() : nullptr)
+			{
+				Memory->Report();
+			}
+		})
+	);
+
+	/** Resets the peak values */
+	static FAutoConsoleCommandWithWorld ResetPeaksCommand(
+		TEXT("nc.Memory.ResetPeaks"),
+		TEXT("Resets the peak memory and object counts of each gameplay subsystem to their current values"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UMemoryBudgetSubsystem* Memory = World ? World->GetSubsystem<UMemoryBudgetSubsystem>() : nullptr)
+			{
+				Memory->ResetPeaks();
+			}
+		})
+	);
+
+	/** Formats a byte count in megabytes, or n/a if it isn't tracked */
+	static FString FormatMB(int64 Bytes)
+	{
+		return Bytes < 0 ? FString(TEXT("n/a")) : FString::Printf(TEXT("%.2f"), Bytes / (1024.0 * 1024.0));
+	}
+}
+
+void UMemoryBudgetSubsystem::Report()
+{
+	Sample();
+
+	FString Table = FString::Printf(TEXT("%-12s %8s %8s %10s %10s %10s\n"), TEXT("Subsystem"), TEXT("Count"), TEXT("Peak"), TEXT("MB"), TEXT("Peak MB"), TEXT("Budget MB"));
+
+	for (int32 Index = 0; Index < (int32)ECategory::Num; ++Index)
+	{
+		const TCHAR* Name = GetCategoryName((ECategory)Index);
+		const FCategorySample& CategorySample = Samples[Index];
+
+		// flag categories that went over budget
+		const float* Budget = BudgetsMB.Find(Name);
+		const bool bOverBudget = Budget && CategorySample.PeakBytes > int64(*Budget * 1024.0f * 1024.0f);
+
+		Table += FString::Printf(TEXT("%-12s %8d %8d %10s %10s %10s%s\n"),
+			Name, CategorySample.Count, CategorySample.PeakCount,
+			*MemoryBudget::FormatMB(CategorySample.Bytes), *MemoryBudget::FormatMB(CategorySample.PeakBytes),
+			Budget ? *FString::Printf(TEXT("%.1f"), *Budget) : TEXT("-"),
+			bOverBudget ? TEXT("  OVER BUDGET") : TEXT(""));
+	}
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Gameplay memory:\n%s"), *Table);
+}
+
+void UMemoryBudgetSubsystem::ResetPeaks()
+{
+	for (FCategorySample& CategorySample : Samples)
+	{
+		CategorySample.PeakCount = CategorySample.Count;
+		CategorySample.PeakBytes = CategorySample.Bytes;
+	}
+}
+
+const TCHAR* UMemoryBudgetSubsystem::GetCategoryName(ECategory Category)
+{
+	switch (Category)
+	{
+	case ECategory::Projectiles:	return TEXT("Projectiles");
+	case ECategory::Enemies:		return TEXT("Enemies");
+	case ECategory::Spawners:		return TEXT("Spawners");
+	case ECategory::UI:				return TEXT("UI");
+	case ECategory::VFX:			return TEXT("VFX");
+	case ECategory::Timers:			return TEXT("Timers");
+	default:						return TEXT("Unknown");
+	}
+}
+
+void UMemoryBudgetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (SampleInterval <= 0.0f)
+	{
+		return;
+	}
+
+	TimeSinceSample += DeltaTime;
+
+	if (TimeSinceSample >= SampleInterval)
+	{
+		TimeSinceSample = 0.0f;
+		Sample();
+	}
+}
+
+TStatId UMemoryBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMemoryBudgetSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+bool UMemoryBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMemoryBudgetSubsystem::Sample()
+{
+	for (int32 Index = 0; Index < (int32)ECategory::Num; ++Index)
+	{
+		FCategorySample& CategorySample = Samples[Index];
+
+		CategorySample.Count = CountObjects((ECategory)Index);
+		CategorySample.PeakCount = FMath::Max(CategorySample.PeakCount, CategorySample.Count);
+
+		CategorySample.Bytes = GetTrackedBytes((ECategory)Index);
+		CategorySample.PeakBytes = FMath::Max(CategorySample.PeakBytes, CategorySample.Bytes);
+	}
+}
+
+int32 UMemoryBudgetSubsystem::CountObjects(ECategory Category) const
+{
+	UWorld* World = GetWorld();
+	int32 Count = 0;
+
+	switch (Category)
+	{
+	case ECategory::Projectiles:
+
+		for (TActorIterator<AProjectile> It(World); It; ++It)
+		{
+			++Count;
+		}
+
+		break;
+
+	case ECategory::Enemies:
+
+		for (TActorIterator<ACombatEnemy> It(World); It; ++It)
+		{
+			++Count;
+		}
+
+		break;
+
+	case ECategory::Spawners:
+
+		for (TActorIterator<ACombatEnemySpawner> It(World); It; ++It)
+		{
+			++Count;
+		}
+
+		break;
+
+	case ECategory::UI:
+
+		for (TObjectIterator<UUserWidget> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				++Count;
+			}
+		}
+
+		break;
+
+	case ECategory::VFX:
+
+		for (TObjectIterator<UFXSystemComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->IsActive())
+			{
+				++Count;
+			}
+		}
+
+		break;
+
+	case ECategory::Timers:
+
+		if (const UGameplayTimerSubsystem* Timers = World->GetSubsystem<UGameplayTimerSubsystem>())
+		{
+			Count = Timers->GetNumActiveTimers();
+		}
+
+		break;
+
+	default:
+		break;
+	}
+
+	return Count;
+}
+
+int64 UMemoryBudgetSubsystem::GetTrackedBytes(ECategory Category)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		return -1;
+	}
+
+	static const FName TagNames[(int32)ECategory::Num] =
+	{
+		TEXT("NCProjectiles"),
+		TEXT("NCEnemies"),
+		TEXT("NCSpawners"),
+		TEXT("NCUI"),
+		TEXT("NCVFX"),
+		TEXT("NCTimers")
+	};
+
+	return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagNames[(int32)Category], ELLMTagSet::None);
+
+#else
+
+	return -1;
+
+#endif
+}
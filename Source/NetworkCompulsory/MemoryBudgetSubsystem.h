@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "MemoryBudgetSubsystem.generated.h"
+
+/** Low level memory tracker tags for each gameplay subsystem. Tag allocations with LLM_SCOPE_BYTAG, view them with -llm and "stat LLMFULL" */
+LLM_DECLARE_TAG(NCProjectiles);
+LLM_DECLARE_TAG(NCEnemies);
+LLM_DECLARE_TAG(NCSpawners);
+LLM_DECLARE_TAG(NCUI);
+LLM_DECLARE_TAG(NCVFX);
+LLM_DECLARE_TAG(NCTimers);
+
+/**
+ *  Tracks memory use and live object counts for each gameplay subsystem.
+ *  Samples the LLM tags and counts live projectiles, enemies, spawners, user widgets, FX components and gameplay timers,
+ *  keeping the peak of each so budgets can be set for server and client hardware.
+ *  Memory columns need LLM, which is enabled with -llm in non-shipping builds. Counts are always available.
+ *  Print the table with nc.Memory.Report, and reset the peaks with nc.Memory.ResetPeaks
+ */
+UCLASS(config=Game)
+class UMemoryBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Gameplay subsystems tracked by the memory table */
+	enum class ECategory : uint8
+	{
+		Projectiles,
+		Enemies,
+		Spawners,
+		UI,
+		VFX,
+		Timers,
+		Num
+	};
+
+protected:
+
+	/** Time between samples. Zero only samples when a report is requested */
+	UPROPERTY(Config, EditAnywhere, Category="Memory", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float SampleInterval = 1.0f;
+
+	/** Memory budget for each category, by category name. Categories over budget are flagged in the report */
+	UPROPERTY(Config, EditAnywhere, Category="Memory", meta = (Units = "MB"))
+	TMap<FName, float> BudgetsMB;
+
+	/** Latest and peak values of a single category */
+	struct FCategorySample
+	{
+		int32 Count = 0;
+		int32 PeakCount = 0;
+
+		/** LLM tracked bytes. Negative if LLM isn't running */
+		int64 Bytes = -1;
+		int64 PeakBytes = -1;
+	};
+
+	/** Samples for each category */
+	FCategorySample Samples[(int32)ECategory::Num];
+
+	/** Time since the last sample */
+	float TimeSinceSample = 0.0f;
+
+public:
+
+	/** Samples every category and logs the memory table */
+	void Report();
+
+	/** Resets the peak values to the current ones */
+	void ResetPeaks();
+
+	/** Returns the display name of the category */
+	static const TCHAR* GetCategoryName(ECategory Category);
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Samples the categories at the configured interval */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Updates the current and peak values of every category */
+	void Sample();
+
+	/** Returns the number of live objects in the category */
+	int32 CountObjects(ECategory Category) const;
+
+	/** Returns the LLM tracked bytes for the category, or -1 if LLM isn't running */
+	static int64 GetTrackedBytes(ECategory Category);
+};
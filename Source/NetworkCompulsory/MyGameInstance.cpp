@@ -1,10 +1,19 @@
 #include "MyGameInstance.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/Engine.h"
+#include "Engine/World.h"
 #include "GameFramework/PlayerController.h"
+#include "Misc/PackageName.h"
 
 void UMyGameInstance::HostLANGame(const FName MapName)
 {
+	// already hosting, so move everyone over without dropping them
+	if (GetWorld() && GetWorld()->GetNetMode() == NM_ListenServer)
+	{
+		TravelToMap(MapName);
+		return;
+	}
+
 	FString Options = MapName.ToString() + TEXT("?listen");
 	UGameplayStatics::OpenLevel(GetWorld(),MapName,true,Options);
 	if (GEngine) GEngine->AddOnScreenDebugMessage(-1,3.f,FColor::Red,TEXT("Hosting LAN"));
@@ -23,4 +32,65 @@ void UMyGameInstance::JoinLANGame(const FString& ServerAddress)
 	}
 }
 
+void UMyGameInstance::StartLANBrowse()
+{
+	if (ULANDiscoverySubsystem* Discovery = GetSubsystem<ULANDiscoverySubsystem>())
+	{
+		Discovery->StartBrowsing();
+	}
+}
+
+void UMyGameInstance::StopLANBrowse()
+{
+	if (ULANDiscoverySubsystem* Discovery = GetSubsystem<ULANDiscoverySubsystem>())
+	{
+		Discovery->StopBrowsing();
+	}
+}
+
+TArray<FLANServerInfo> UMyGameInstance::GetLANServers() const
+{
+	const ULANDiscoverySubsystem* Discovery = GetSubsystem<ULANDiscoverySubsystem>();
 
+	return Discovery ? Discovery->GetServers() : TArray<FLANServerInfo>();
+}
+
+void UMyGameInstance::JoinLANServer(const FLANServerInfo& Server)
+{
+	StopLANBrowse();
+	JoinLANGame(Server.Address);
+}
+
+void UMyGameInstance::TravelToMap(const FName MapName)
+{
+	UWorld* World = GetWorld();
+
+	// only the server can move the session
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	// the game modes use seamless travel, so clients stay connected while the map streams in behind the transition map
+	World->ServerTravel(MapName.ToString() + TEXT("?listen"));
+
+	if (GEngine)
+	{
+		FString Msg = FString::Printf(TEXT("Travelling to %s"), *MapName.ToString());
+		GEngine->AddOnScreenDebugMessage(-1,3.f,FColor::Red,Msg);
+	}
+}
+
+void UMyGameInstance::TravelToNextMap()
+{
+	if (MapRotation.IsEmpty())
+	{
+		return;
+	}
+
+	// find the current map in the rotation. Maps outside of it start the rotation over
+	const FString CurrentMap = UGameplayStatics::GetCurrentLevelName(GetWorld());
+	const int32 CurrentIndex = MapRotation.IndexOfByPredicate([&CurrentMap](const FString& Map) { return FPackageName::GetShortName(Map) == CurrentMap; });
+
+	TravelToMap(FName(MapRotation[(CurrentIndex + 1) % MapRotation.Num()]));
+}
@@ -2,20 +2,63 @@
 
 #include "CoreMinimal.h"
 #include "Engine/GameInstance.h"
+#include "LANDiscoverySubsystem.h"
 #include "MyGameInstance.generated.h"
 
 /**
  * 
  */
-UCLASS()
+UCLASS(config=Game)
 class NETWORKCOMPULSORY_API UMyGameInstance : public UGameInstance
 {
 	GENERATED_BODY()
 	
+	protected:
+
+		/** Maps visited in order by TravelToNextMap */
+		UPROPERTY(Config)
+		TArray<FString> MapRotation;
+
+		/** If true, maps hosted by this game instance are recorded as match replays */
+		UPROPERTY(Config)
+		bool bRecordMatches = false;
+
 	public:
 		UFUNCTION(BlueprintCallable)
 		void HostLANGame(const FName MapName);
 	
 		UFUNCTION(BlueprintCallable)
 		void JoinLANGame(const FString& ServerAddress);
+
+		/** Starts looking for LAN servers. Found servers are cached and refreshed until the browser is stopped */
+		UFUNCTION(BlueprintCallable)
+		void StartLANBrowse();
+
+		/** Stops looking for LAN servers */
+		UFUNCTION(BlueprintCallable)
+		void StopLANBrowse();
+
+		/** Returns the LAN servers found by the browser */
+		UFUNCTION(BlueprintPure)
+		TArray<FLANServerInfo> GetLANServers() const;
+
+		/** Stops the browser and joins the provided server */
+		UFUNCTION(BlueprintCallable)
+		void JoinLANServer(const FLANServerInfo& Server);
+
+		/** Seamlessly travels the server and all connected clients to the provided map. Server only */
+		UFUNCTION(BlueprintCallable)
+		void TravelToMap(const FName MapName);
+
+		/** Travels to the map after the current one in the map rotation. Server only */
+		UFUNCTION(BlueprintCallable)
+		void TravelToNextMap();
+
+		/** Enables or disables match recording. Takes effect from the next hosted map */
+		UFUNCTION(BlueprintCallable)
+		void SetRecordMatches(bool bRecord) { bRecordMatches = bRecord; }
+
+		/** Returns true if hosted maps are recorded as match replays */
+		UFUNCTION(BlueprintPure)
+		bool ShouldRecordMatches() const { return bRecordMatches; }
 };
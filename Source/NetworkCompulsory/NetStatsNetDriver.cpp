@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "NetStatsNetDriver.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "NetStatsSubsystem.h"
+
+void UNetStatsNetDriver::ProcessRemoteFunction(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject)
+{
+	UWorld* NetWorld = GetWorld();
+	UNetStatsSubsystem* NetStats = NetWorld ? NetWorld->GetSubsystem<UNetStatsSubsystem>() : nullptr;
+
+	// nothing to measure unless we're capturing
+	if (!NetStats || !NetStats->IsCapturing())
+	{
+		Super::ProcessRemoteFunction(Actor, Function, Parameters, OutParms, Stack, SubObject);
+		return;
+	}
+
+	// servers send to every client, clients only to the server
+	TArray<UNetConnection*, TInlineAllocator<16>> Connections;
+
+	if (ServerConnection)
+	{
+		Connections.Add(ServerConnection);
+
+	} else {
+
+		Connections.Append(ClientConnections);
+	}
+
+	TArray<int64, TInlineAllocator<16>> BitsBefore;
+
+	for (const UNetConnection* Connection : Connections)
+	{
+		BitsBefore.Add(Connection ? GetBitsWritten(Connection) : 0);
+	}
+
+	Super::ProcessRemoteFunction(Actor, Function, Parameters, OutParms, Stack, SubObject);
+
+	int64 SentBits = 0;
+
+	for (int32 Index = 0; Index < Connections.Num(); ++Index)
+	{
+		if (Connections[Index])
+		{
+			SentBits += FMath::Max<int64>(GetBitsWritten(Connections[Index]) - BitsBefore[Index], 0);
+		}
+	}
+
+	NetStats->RecordRemoteFunction(Actor, SubObject, Function, Parameters, (SentBits + 7) / 8);
+}
+
+int64 UNetStatsNetDriver::GetBitsWritten(const UNetConnection* Connection)
+{
+	// an RPC that fills the send buffer flushes it, so count what went out as well as what's still waiting
+	return int64(Connection->OutTotalBytes) * 8 + Connection->SendBuffer.GetNumBits();
+}
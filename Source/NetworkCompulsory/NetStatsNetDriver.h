@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IpNetDriver.h"
+#include "NetStatsNetDriver.generated.h"
+
+/**
+ *  Game net driver used for bandwidth profiling.
+ *  Measures the bytes every RPC writes to the connections, whichever actor or component sends it,
+ *  and passes them to the net stats subsystem while it's capturing
+ */
+UCLASS(transient, config=Engine)
+class UNetStatsNetDriver : public UIpNetDriver
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Sends the RPC and records the bytes it wrote to each connection */
+	virtual void ProcessRemoteFunction(class AActor* Actor, class UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, struct FFrame* Stack, class UObject* SubObject = nullptr) override;
+
+protected:
+
+	/** Returns the bits the connection has sent so far plus the bits waiting in its send buffer */
+	static int64 GetBitsWritten(const UNetConnection* Connection);
+};
@@ -0,0 +1,527 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "NetStatsSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/UnrealNetwork.h"
+#include "NetworkCompulsory.h"
+
+namespace NetworkStats
+{
+	/** Starts recording network traffic */
+	static FAutoConsoleCommandWithWorld StartCommand(
+		TEXT("nc.NetStats.Start"),
+		TEXT("Starts recording outgoing network traffic per actor class, replicated property and RPC"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UNetStatsSubsystem* NetStats = World ? World->GetSubsystem<UNetStatsSubsystem>() : nullptr)
+			{
+				NetStats->StartCapture();
+			}
+		})
+	);
+
+	/** Stops recording network traffic */
+	static FAutoConsoleCommandWithWorld StopCommand(
+		TEXT("nc.NetStats.Stop"),
+		TEXT("Stops recording network traffic. The history is kept for export"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UNetStatsSubsystem* NetStats = World ? World->GetSubsystem<UNetStatsSubsystem>() : nullptr)
+			{
+				NetStats->StopCapture();
+			}
+		})
+	);
+
+	/** Toggles the on screen breakdown */
+	static FAutoConsoleCommandWithWorld ShowCommand(
+		TEXT("nc.NetStats.Show"),
+		TEXT("Toggles the on screen breakdown of the last second of network traffic"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UNetStatsSubsystem* NetStats = World ? World->GetSubsystem<UNetStatsSubsystem>() : nullptr)
+			{
+				NetStats->ToggleOnScreen();
+			}
+		})
+	);
+
+	/** Exports the recorded history */
+	static FAutoConsoleCommandWithWorldAndArgs ExportCommand(
+		TEXT("nc.NetStats.Export"),
+		TEXT("Writes the recorded network traffic history to Saved/NetStats. Pass json for JSON output, CSV otherwise"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UNetStatsSubsystem* NetStats = World ? World->GetSubsystem<UNetStatsSubsystem>() : nullptr)
+			{
+				NetStats->Export(Args.Num() > 0 && Args[0] == TEXT("json"));
+			}
+		})
+	);
+
+	/** Returns a hash of the property value, used to detect changes */
+	static uint32 HashPropertyValue(const FProperty* Property, const void* Value)
+	{
+		if (Property->HasAllPropertyFlags(CPF_HasGetValueTypeHash))
+		{
+			return Property->GetValueTypeHash(Value);
+		}
+
+		// plain structs can be hashed as raw memory
+		if (Property->HasAnyPropertyFlags(CPF_IsPlainOldData))
+		{
+			return FCrc::MemCrc32(Value, Property->GetElementSize());
+		}
+
+		// fall back to the text form for containers and structs with pointers
+		FString Text;
+		Property->ExportTextItem_Direct(Text, Value, nullptr, nullptr, PPF_None);
+
+		return FCrc::StrCrc32(*Text);
+	}
+
+	/** Returns a rough size for the property value. Uses the in-memory size, so quantized and delta serialized values are overestimated */
+	static int64 EstimatePropertyBytes(const FProperty* Property, const void* Value)
+	{
+		if (Property->IsA<FBoolProperty>())
+		{
+			return 1;
+		}
+
+		if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+		{
+			return sizeof(int32) + StrProperty->GetPropertyValue(Value).Len();
+		}
+
+		if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+
+			int64 Bytes = sizeof(int32);
+
+			for (int32 Index = 0; Index < ArrayHelper.Num(); ++Index)
+			{
+				Bytes += EstimatePropertyBytes(ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index));
+			}
+
+			return Bytes;
+		}
+
+		return Property->GetElementSize();
+	}
+
+	/** Returns the entries of a stat map, largest first */
+	static TArray<TPair<FName, int64>> SortByBytes(const TMap<FName, int64>& Map)
+	{
+		TArray<TPair<FName, int64>> Entries = Map.Array();
+		Entries.Sort([](const TPair<FName, int64>& A, const TPair<FName, int64>& B) { return A.Value > B.Value; });
+
+		return Entries;
+	}
+
+	/** Appends a stat map as a JSON object */
+	static void AppendJsonMap(FString& Out, const TCHAR* Name, const TMap<FName, int64>& Map)
+	{
+		Out += FString::Printf(TEXT("\"%s\":{"), Name);
+
+		bool bFirst = true;
+
+		for (const TPair<FName, int64>& Entry : Map)
+		{
+			Out += FString::Printf(TEXT("%s\"%s\":%lld"), bFirst ? TEXT("") : TEXT(","), *Entry.Key.ToString(), Entry.Value);
+			bFirst = false;
+		}
+
+		Out += TEXT("}");
+	}
+}
+
+void UNetStatsSubsystem::StartCapture()
+{
+	History.Reset();
+	TrackedActors.Reset();
+	Current = FNetStatsSecond();
+
+	RefreshReplicatedActors();
+
+	SecondStartTime = GetWorld()->GetRealTimeSeconds();
+	bCapturing = true;
+
+	UE_LOG(LogNetworkCompulsory, Log, TEXT("Net stats: capture started"));
+}
+
+void UNetStatsSubsystem::StopCapture()
+{
+	bCapturing = false;
+
+	UE_LOG(LogNetworkCompulsory, Log, TEXT("Net stats: capture stopped, %d seconds recorded"), History.Num());
+}
+
+void UNetStatsSubsystem::ToggleOnScreen()
+{
+	bShowOnScreen = !bShowOnScreen;
+
+	// showing the breakdown needs something to show
+	if (bShowOnScreen && !bCapturing)
+	{
+		StartCapture();
+	}
+}
+
+FString UNetStatsSubsystem::Export(bool bJson) const
+{
+	FString Out;
+
+	if (bJson)
+	{
+		Out = TEXT("[");
+
+		for (int32 Index = 0; Index < History.Num(); ++Index)
+		{
+			const FNetStatsSecond& Second = History[Index];
+
+			Out += FString::Printf(TEXT("%s{\"time\":%.3f,\"totalOutBytes\":%lld,"), Index > 0 ? TEXT(",\n") : TEXT("\n"), Second.Time, Second.TotalOutBytes);
+
+			NetworkStats::AppendJsonMap(Out, TEXT("classes"), Second.ClassBytes);
+			Out += TEXT(",");
+			NetworkStats::AppendJsonMap(Out, TEXT("estimatedProperties"), Second.EstimatedPropertyBytes);
+			Out += TEXT(",");
+			NetworkStats::AppendJsonMap(Out, TEXT("rpcs"), Second.RPCBytes);
+			Out += TEXT("}");
+		}
+
+		Out += TEXT("\n]\n");
+
+	} else {
+
+		Out = TEXT("Time,Category,Name,Bytes\n");
+
+		for (const FNetStatsSecond& Second : History)
+		{
+			Out += FString::Printf(TEXT("%.3f,Total,NetDriver,%lld\n"), Second.Time, Second.TotalOutBytes);
+
+			for (const TPair<FName, int64>& Entry : Second.ClassBytes)
+			{
+				Out += FString::Printf(TEXT("%.3f,Class,%s,%lld\n"), Second.Time, *Entry.Key.ToString(), Entry.Value);
+			}
+
+			for (const TPair<FName, int64>& Entry : Second.EstimatedPropertyBytes)
+			{
+				Out += FString::Printf(TEXT("%.3f,PropertyEstimate,%s,%lld\n"), Second.Time, *Entry.Key.ToString(), Entry.Value);
+			}
+
+			for (const TPair<FName, int64>& Entry : Second.RPCBytes)
+			{
+				Out += FString::Printf(TEXT("%.3f,RPC,%s,%lld\n"), Second.Time, *Entry.Key.ToString(), Entry.Value);
+			}
+		}
+	}
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("NetStats") / FString::Printf(TEXT("NetStats-%s.%s"), *FDateTime::Now().ToString(), bJson ? TEXT("json") : TEXT("csv"));
+
+	if (!FFileHelper::SaveStringToFile(Out, *Path))
+	{
+		UE_LOG(LogNetworkCompulsory, Error, TEXT("Net stats: could not write %s"), *Path);
+		return FString();
+	}
+
+	UE_LOG(LogNetworkCompulsory, Log, TEXT("Net stats: wrote %d seconds to %s"), History.Num(), *Path);
+
+	return Path;
+}
+
+void UNetStatsSubsystem::RecordRemoteFunction(const AActor* Actor, const UObject* SubObject, const UFunction* Function, const void* Parameters, int64 SentBytes)
+{
+	if (!bCapturing || !Actor || !Function)
+	{
+		return;
+	}
+
+	int64 Bytes = SentBytes;
+
+	// unreliable multicasts are queued and sent with the actor's next update, so estimate those from the parameters
+	if (Bytes == 0 && Parameters && Function->HasAnyFunctionFlags(FUNC_NetMulticast) && !Function->HasAnyFunctionFlags(FUNC_NetReliable))
+	{
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_ReturnParm))
+			{
+				Bytes += NetworkStats::EstimatePropertyBytes(*It, It->ContainerPtrToValuePtr<void>(Parameters));
+			}
+		}
+
+		Bytes *= GetNumReplicatedConnections(GetWorld()->GetNetDriver(), Actor);
+	}
+
+	// component RPCs are keyed by the component class, but counted against the owning actor
+	const FName ClassName = Actor->GetClass()->GetFName();
+	const UClass* SenderClass = SubObject ? SubObject->GetClass() : Actor->GetClass();
+
+	AddRPCBytes(ClassName, FName(*FString::Printf(TEXT("%s.%s"), *SenderClass->GetName(), *Function->GetName())), Bytes);
+}
+
+void UNetStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World->GetNetDriver();
+
+	const double Time = World->GetRealTimeSeconds();
+
+	// only the server replicates properties
+	if (NetDriver && NetDriver->IsServer())
+	{
+		CheckReplicatedActors(NetDriver, Time);
+	}
+
+	// roll the history over
+	if (Time - SecondStartTime >= 1.0)
+	{
+		FinishSecond(NetDriver, Time);
+
+		// pick up newly spawned and streamed in actors
+		RefreshReplicatedActors();
+
+		if (bShowOnScreen)
+		{
+			ShowOnScreen();
+		}
+	}
+}
+
+TStatId UNetStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNetStatsSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+bool UNetStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNetStatsSubsystem::CheckReplicatedActors(UNetDriver* NetDriver, double Time)
+{
+	for (const TWeakObjectPtr<AActor>& WeakActor : ReplicatedActors)
+	{
+		AActor* Actor = WeakActor.Get();
+
+		if (!Actor || !Actor->GetIsReplicated())
+		{
+			continue;
+		}
+
+		FTrackedActor& Tracked = TrackedActors.FindOrAdd(Actor);
+
+		// only check at the rate the actor is considered for replication
+		if (Time - Tracked.LastCheckTime < 1.0 / FMath::Max(Actor->GetNetUpdateFrequency(), 1.0f))
+		{
+			continue;
+		}
+
+		Tracked.LastCheckTime = Time;
+
+		const TArray<FTrackedProperty>& Properties = GetClassProperties(Actor->GetClass());
+		const bool bFirstCheck = Tracked.Hashes.Num() != Properties.Num();
+
+		if (bFirstCheck)
+		{
+			Tracked.Hashes.SetNumZeroed(Properties.Num());
+		}
+
+		// dormant actors have no open channels, so they count as sent to nobody
+		const int32 NumConnections = GetNumReplicatedConnections(NetDriver, Actor);
+
+		for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+		{
+			const FProperty* Property = Properties[PropertyIndex].Property;
+
+			// hash every element of static arrays
+			uint32 Hash = 0;
+			int64 Bytes = 0;
+
+			for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex)
+			{
+				const void* Value = Property->ContainerPtrToValuePtr<void>(Actor, ArrayIndex);
+
+				Hash = HashCombineFast(Hash, NetworkStats::HashPropertyValue(Property, Value));
+				Bytes += NetworkStats::EstimatePropertyBytes(Property, Value);
+			}
+
+			// owner only properties go to a single connection at most
+			const ELifetimeCondition Condition = Properties[PropertyIndex].Condition;
+			const int32 PropertyConnections = (Condition == COND_OwnerOnly || Condition == COND_AutonomousOnly) ? FMath::Min(NumConnections, 1) : NumConnections;
+
+			// the first check only establishes the baseline
+			if (!bFirstCheck && Hash != Tracked.Hashes[PropertyIndex] && PropertyConnections > 0)
+			{
+				AddPropertyEstimate(Properties[PropertyIndex].Key, Bytes * PropertyConnections);
+			}
+
+			Tracked.Hashes[PropertyIndex] = Hash;
+		}
+	}
+}
+
+void UNetStatsSubsystem::RefreshReplicatedActors()
+{
+	ReplicatedActors.Reset();
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (It->GetIsReplicated())
+		{
+			ReplicatedActors.Add(*It);
+		}
+	}
+
+	// forget destroyed actors
+	for (auto It = TrackedActors.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+const TArray<UNetStatsSubsystem::FTrackedProperty>& UNetStatsSubsystem::GetClassProperties(UClass* Class)
+{
+	if (const TArray<FTrackedProperty>* Found = ClassProperties.Find(Class))
+	{
+		return *Found;
+	}
+
+	TArray<FTrackedProperty>& Properties = ClassProperties.Add(Class);
+
+	// look up each property's replication condition
+	TArray<FLifetimeProperty> LifetimeProperties;
+	Class->GetDefaultObject()->GetLifetimeReplicatedProps(LifetimeProperties);
+
+	TMap<uint16, ELifetimeCondition> Conditions;
+
+	for (const FLifetimeProperty& LifetimeProperty : LifetimeProperties)
+	{
+		Conditions.Add(LifetimeProperty.RepIndex, LifetimeProperty.Condition);
+	}
+
+	for (TFieldIterator<FProperty> It(Class); It; ++It)
+	{
+		if (!It->HasAnyPropertyFlags(CPF_Net))
+		{
+			continue;
+		}
+
+		const ELifetimeCondition Condition = Conditions.FindRef(It->RepIndex, COND_None);
+
+		// skip properties that are never sent after the initial bunch
+		if (Condition == COND_InitialOnly || Condition == COND_InitialOrOwner || Condition == COND_ReplayOnly || Condition == COND_Never)
+		{
+			continue;
+		}
+
+		Properties.Add({ *It, FName(*FString::Printf(TEXT("%s.%s"), *Class->GetName(), *It->GetName())), Condition });
+	}
+
+	return Properties;
+}
+
+void UNetStatsSubsystem::AddRPCBytes(FName ClassName, FName Key, int64 Bytes)
+{
+	Current.ClassBytes.FindOrAdd(ClassName) += Bytes;
+	Current.RPCBytes.FindOrAdd(Key) += Bytes;
+}
+
+void UNetStatsSubsystem::AddPropertyEstimate(FName Key, int64 Bytes)
+{
+	Current.EstimatedPropertyBytes.FindOrAdd(Key) += Bytes;
+}
+
+void UNetStatsSubsystem::FinishSecond(UNetDriver* NetDriver, double Time)
+{
+	Current.Time = Time;
+	Current.TotalOutBytes = NetDriver ? NetDriver->OutBytesPerSecond : 0;
+
+	History.Add(MoveTemp(Current));
+	Current = FNetStatsSecond();
+
+	// drop the oldest seconds
+	if (History.Num() > HistorySeconds)
+	{
+		History.RemoveAt(0, History.Num() - HistorySeconds);
+	}
+
+	SecondStartTime = Time;
+}
+
+void UNetStatsSubsystem::ShowOnScreen() const
+{
+	if (!GEngine || History.IsEmpty())
+	{
+		return;
+	}
+
+	const FNetStatsSecond& Last = History.Last();
+
+	// use fixed keys so each refresh replaces the previous one
+	int32 Key = 0x4E535400;
+
+	auto ShowCategory = [this, &Key](const TCHAR* Title, const TMap<FName, int64>& Map)
+	{
+		const TArray<TPair<FName, int64>> Entries = NetworkStats::SortByBytes(Map);
+
+		FString Text = Title;
+
+		for (int32 Index = 0; Index < FMath::Min(Entries.Num(), NumOnScreenEntries); ++Index)
+		{
+			Text += FString::Printf(TEXT("\n  %s: %.2f KB/s"), *Entries[Index].Key.ToString(), Entries[Index].Value / 1024.0f);
+		}
+
+		GEngine->AddOnScreenDebugMessage(Key++, 1.5f, FColor::Cyan, Text);
+	};
+
+	ShowCategory(TEXT("RPCs"), Last.RPCBytes);
+	ShowCategory(TEXT("Properties (estimated)"), Last.EstimatedPropertyBytes);
+	ShowCategory(TEXT("Actor classes (RPCs)"), Last.ClassBytes);
+
+	GEngine->AddOnScreenDebugMessage(Key++, 1.5f, FColor::Cyan, FString::Printf(TEXT("Net out: %.2f KB/s"), Last.TotalOutBytes / 1024.0f));
+}
+
+int32 UNetStatsSubsystem::GetNumReplicatedConnections(const UNetDriver* NetDriver, const AActor* Actor)
+{
+	if (!NetDriver)
+	{
+		return 0;
+	}
+
+	// clients only send to the server
+	if (!NetDriver->IsServer())
+	{
+		return 1;
+	}
+
+	int32 NumConnections = 0;
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection && Connection->FindActorChannelRef(const_cast<AActor*>(Actor)))
+		{
+			++NumConnections;
+		}
+	}
+
+	return NumConnections;
+}
@@ -0,0 +1,160 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/CoreNetTypes.h"
+#include "NetStatsSubsystem.generated.h"
+
+class UNetDriver;
+
+/**
+ *  One second of outgoing network traffic, broken down by source
+ */
+struct FNetStatsSecond
+{
+	/** Real world time at the end of this second */
+	double Time = 0.0;
+
+	/** Outgoing bytes per second measured by the net driver */
+	int64 TotalOutBytes = 0;
+
+	/** RPC bytes per actor class, as measured by the net driver */
+	TMap<FName, int64> ClassBytes;
+
+	/** Estimated bytes per replicated property, keyed as Class.Property. Not part of the measured totals */
+	TMap<FName, int64> EstimatedPropertyBytes;
+
+	/** Bytes per RPC, keyed as Class.Function */
+	TMap<FName, int64> RPCBytes;
+};
+
+/**
+ *  Network bandwidth profiler.
+ *  Attributes outgoing traffic to actor classes, replicated properties and RPCs, and keeps a rolling per-second history.
+ *  - RPC traffic is measured by UNetStatsNetDriver as each RPC is written to the connections, so it covers every actor and component.
+ *    Unreliable multicasts are queued until the actor's next update, so those are estimated from their parameters
+ *  - Property traffic is only a rough estimate, kept in its own column and left out of the per-class totals. The server checks each
+ *    replicated actor for changed properties at its net update rate and charges the in-memory size of each change, not its serialized
+ *    size. Use Networking Insights (-trace=net -NetTrace=1) for real per-property bits
+ *  - The net driver's measured total is kept alongside the breakdown for comparison
+ *  Control it with nc.NetStats.Start, nc.NetStats.Stop, nc.NetStats.Show and nc.NetStats.Export [csv|json]
+ */
+UCLASS(config=Game)
+class UNetStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of seconds of history to keep */
+	UPROPERTY(Config, EditAnywhere, Category="Net Stats", meta = (ClampMin = 1, ClampMax = 3600, Units = "s"))
+	int32 HistorySeconds = 120;
+
+	/** Number of entries per category shown on screen */
+	UPROPERTY(Config, EditAnywhere, Category="Net Stats", meta = (ClampMin = 1, ClampMax = 32))
+	int32 NumOnScreenEntries = 6;
+
+	/** Replicated property of an actor class, with its precomputed stat key and replication condition */
+	struct FTrackedProperty
+	{
+		const FProperty* Property = nullptr;
+		FName Key;
+		ELifetimeCondition Condition = COND_None;
+	};
+
+	/** Last known state of a replicated actor */
+	struct FTrackedActor
+	{
+		/** Value hash of each tracked property, in class order */
+		TArray<uint32> Hashes;
+
+		/** Real world time of the last property check */
+		double LastCheckTime = 0.0;
+	};
+
+	/** Replicated properties of each actor class seen so far */
+	TMap<TObjectKey<UClass>, TArray<FTrackedProperty>> ClassProperties;
+
+	/** Property state of each replicated actor */
+	TMap<TObjectKey<AActor>, FTrackedActor> TrackedActors;
+
+	/** Replicated actors in the world, refreshed once a second */
+	TArray<TWeakObjectPtr<AActor>> ReplicatedActors;
+
+	/** Completed seconds, oldest first */
+	TArray<FNetStatsSecond> History;
+
+	/** Second currently being accumulated */
+	FNetStatsSecond Current;
+
+	/** Real world time at the start of the current second */
+	double SecondStartTime = 0.0;
+
+	/** If true, traffic is being recorded */
+	bool bCapturing = false;
+
+	/** If true, the last second's breakdown is shown on screen */
+	bool bShowOnScreen = false;
+
+public:
+
+	/** Starts recording traffic, clearing any previous history */
+	void StartCapture();
+
+	/** Stops recording traffic. The history is kept for export */
+	void StopCapture();
+
+	/** Toggles the on screen breakdown */
+	void ToggleOnScreen();
+
+	/** Returns true if traffic is being recorded */
+	bool IsCapturing() const { return bCapturing; }
+
+	/** Writes the history to Saved/NetStats as CSV or JSON. Returns the file path, or an empty string on failure */
+	FString Export(bool bJson) const;
+
+	/** Records an RPC sent by the provided actor or one of its subobjects, with the bytes the net driver wrote for it */
+	void RecordRemoteFunction(const AActor* Actor, const UObject* SubObject, const UFunction* Function, const void* Parameters, int64 SentBytes);
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Checks replicated actors for changes and rolls the history over every second */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Checks every replicated actor due a net update for changed properties */
+	void CheckReplicatedActors(UNetDriver* NetDriver, double Time);
+
+	/** Rebuilds the list of replicated actors and forgets destroyed ones */
+	void RefreshReplicatedActors();
+
+	/** Returns the replicated properties of the provided class, building them on first use. Properties that are never sent after the initial bunch are left out */
+	const TArray<FTrackedProperty>& GetClassProperties(UClass* Class);
+
+	/** Adds measured RPC bytes to the current second */
+	void AddRPCBytes(FName ClassName, FName Key, int64 Bytes);
+
+	/** Adds estimated property bytes to the current second */
+	void AddPropertyEstimate(FName Key, int64 Bytes);
+
+	/** Closes the current second and adds it to the history */
+	void FinishSecond(UNetDriver* NetDriver, double Time);
+
+	/** Shows the last second's breakdown on screen */
+	void ShowOnScreen() const;
+
+	/** Returns the number of client connections the actor is currently replicated to */
+	static int32 GetNumReplicatedConnections(const UNetDriver* NetDriver, const AActor* Actor);
+};
@@ -21,7 +21,7 @@ public class NetworkCompulsory : ModuleRules
 			"Slate"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] { "RHI", "RenderCore", "Sockets", "Networking", "MoviePlayer", "SlateCore", "OnlineSubsystemUtils" });
 
 		PublicIncludePaths.AddRange(new string[] {
 			"NetworkCompulsory",
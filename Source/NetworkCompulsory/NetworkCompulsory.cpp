@@ -2,7 +2,81 @@
 
 #include "NetworkCompulsory.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/IConsoleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, NetworkCompulsory, "NetworkCompulsory" );
 
-DEFINE_LOG_CATEGORY(LogNetworkCompulsory)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogNetworkCompulsory)
+
+DEFINE_STAT(STAT_NC_AttackTrace);
+DEFINE_STAT(STAT_NC_HandleFire);
+DEFINE_STAT(STAT_NC_ProjectileImpact);
+DEFINE_STAT(STAT_NC_SideScrollingCamera);
+DEFINE_STAT(STAT_NC_MultiJump);
+DEFINE_STAT(STAT_NC_StateTreeTaskTick);
+DEFINE_STAT(STAT_NC_SpawnEnemy);
+
+DEFINE_STAT(STAT_NC_NumAttackTraces);
+DEFINE_STAT(STAT_NC_NumProjectilesFired);
+DEFINE_STAT(STAT_NC_NumProjectileImpacts);
+DEFINE_STAT(STAT_NC_NumStateTreeTaskTicks);
+DEFINE_STAT(STAT_NC_NumEnemiesSpawned);
+DEFINE_STAT(STAT_NC_NumMovementCorrections);
+
+UE_TRACE_CHANNEL_DEFINE(NetworkCompulsoryChannel);
+
+namespace NetworkCompulsoryNet
+{
+	/** Corrections recorded since the last reset */
+	static int32 MovementCorrections = 0;
+
+	/** Platform time when the sampling window started. Initialized on first use, since the platform clock isn't set up during static initialization */
+	static double& GetSampleStartTime()
+	{
+		static double SampleStartTime = FPlatformTime::Seconds();
+		return SampleStartTime;
+	}
+
+	void RecordMovementCorrection()
+	{
+		// start the sampling window if this is the first correction
+		GetSampleStartTime();
+
+		++MovementCorrections;
+
+		INC_DWORD_STAT(STAT_NC_NumMovementCorrections);
+	}
+
+	int32 GetMovementCorrections()
+	{
+		return MovementCorrections;
+	}
+
+	float GetMovementCorrectionsPerMinute()
+	{
+		const double Minutes = (FPlatformTime::Seconds() - GetSampleStartTime()) / 60.0;
+
+		return Minutes > 0.0 ? float(MovementCorrections / Minutes) : 0.0f;
+	}
+
+	void ResetMovementCorrections()
+	{
+		MovementCorrections = 0;
+		GetSampleStartTime() = FPlatformTime::Seconds();
+	}
+
+	/** Logs the movement corrections sent by this server. Pass "reset" to start a new sampling window */
+	static FAutoConsoleCommand CorrectionsCommand(
+		TEXT("nc.Net.Corrections"),
+		TEXT("Logs the movement corrections sent by this server and the corrections per minute. Pass reset to start a new sampling window"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			UE_LOG(LogNetworkCompulsory, Log, TEXT("Movement corrections: %d (%.2f per minute)"), GetMovementCorrections(), GetMovementCorrectionsPerMinute());
+
+			if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+			{
+				ResetMovementCorrections();
+			}
+		})
+	);
+}
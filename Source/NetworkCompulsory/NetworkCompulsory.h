@@ -3,6 +3,55 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HitchMonitor.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogNetworkCompulsory, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogNetworkCompulsory, Log, All);
+
+/** Stat group for gameplay hot paths. View it with "stat NetworkCompulsory" */
+DECLARE_STATS_GROUP(TEXT("NetworkCompulsory"), STATGROUP_NetworkCompulsory, STATCAT_Advanced);
+
+/** Gameplay cycle stats */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attack Trace"), STAT_NC_AttackTrace, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle Fire"), STAT_NC_HandleFire, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Impact"), STAT_NC_ProjectileImpact, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Side Scrolling Camera Update"), STAT_NC_SideScrollingCamera, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Multi Jump"), STAT_NC_MultiJump, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StateTree Task Tick"), STAT_NC_StateTreeTaskTick, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Enemy"), STAT_NC_SpawnEnemy, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+
+/** Gameplay counter stats, reset every frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Attack Traces"), STAT_NC_NumAttackTraces, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectiles Fired"), STAT_NC_NumProjectilesFired, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile Impacts"), STAT_NC_NumProjectileImpacts, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("StateTree Task Ticks"), STAT_NC_NumStateTreeTaskTicks, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Enemies Spawned"), STAT_NC_NumEnemiesSpawned, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Movement Corrections"), STAT_NC_NumMovementCorrections, STATGROUP_NetworkCompulsory, NETWORKCOMPULSORY_API);
+
+/** Insights trace channel for gameplay hot paths. Switch it on at runtime with "Trace.Enable NetworkCompulsory" */
+UE_TRACE_CHANNEL_EXTERN(NetworkCompulsoryChannel, NETWORKCOMPULSORY_API);
+
+/** Scopes a gameplay hot path with its cycle stat, an Insights event on the project trace channel and the hitch monitor */
+#define NC_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, NetworkCompulsoryChannel); \
+	NC_HITCH_SCOPE(#Stat)
+
+/** Network movement statistics, used to track prediction quality during load tests */
+namespace NetworkCompulsoryNet
+{
+	/** Records a movement correction sent by the server to a client */
+	void RecordMovementCorrection();
+
+	/** Returns the number of movement corrections recorded since the last reset */
+	int32 GetMovementCorrections();
+
+	/** Returns the average movement corrections per minute since the last reset */
+	float GetMovementCorrectionsPerMinute();
+
+	/** Resets the movement correction counter and its sampling window */
+	void ResetMovementCorrections();
+}
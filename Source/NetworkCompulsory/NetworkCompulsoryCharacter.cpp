@@ -12,7 +12,9 @@
 #include "InputActionValue.h"
 #include "NetworkCompulsory.h"
 #include "Projectile.h"
+#include "GameplayTimerSubsystem.h"
 #include "Net/UnrealNetwork.h"
+#include "MemoryBudgetSubsystem.h"
 
 ANetworkCompulsoryCharacter::ANetworkCompulsoryCharacter()
 {
@@ -70,7 +72,10 @@ void ANetworkCompulsoryCharacter::StartFire()
 		UE_LOG(LogTemp, Warning, TEXT("Bruh"));
 		bIsFiringWeapon = true;
 		UWorld* World = GetWorld();
-		World->GetTimerManager().SetTimer(FiringTimer, this, &ANetworkCompulsoryCharacter::StopFire, FireRate, false);
+		if (UGameplayTimerSubsystem* Timers = World->GetSubsystem<UGameplayTimerSubsystem>())
+		{
+			Timers->SetTimer(FiringTimer, this, &ANetworkCompulsoryCharacter::StopFire, FireRate);
+		}
 		HandleFire();
 	}
 }
@@ -82,6 +87,10 @@ void ANetworkCompulsoryCharacter::StopFire()
 	 
 void ANetworkCompulsoryCharacter::HandleFire_Implementation()
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_HandleFire);
+	LLM_SCOPE_BYTAG(NCProjectiles);
+	INC_DWORD_STAT(STAT_NC_NumProjectilesFired);
+
 	FVector spawnLocation = GetActorLocation() + ( GetActorRotation().Vector()  * 100.0f ) + (GetActorUpVector() * 50.0f);
 	FRotator spawnRotation = GetActorRotation();
 	 
@@ -231,6 +240,8 @@ void ANetworkCompulsoryCharacter::SetCurrentHealth(float healthValue)
 	 
 float ANetworkCompulsoryCharacter::TakeDamage(float DamageTaken, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	NetworkCompulsoryHitch::RecordEvent(TEXT("TakeDamage"), this);
+
 	float damageApplied = CurrentHealth - DamageTaken;
 	SetCurrentHealth(damageApplied);
 	return damageApplied;
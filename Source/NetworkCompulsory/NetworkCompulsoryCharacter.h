@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
+#include "GameplayTimerSubsystem.h"
 #include "NetworkCompulsoryCharacter.generated.h"
 
 class USpringArmComponent;
@@ -79,7 +80,7 @@ protected:
 	void HandleFire();
 	 
 	/** A timer handle used for providing the fire rate delay in-between spawns.*/
-	FTimerHandle FiringTimer;
+	FGameplayTimerHandle FiringTimer;
 	
 public:
 
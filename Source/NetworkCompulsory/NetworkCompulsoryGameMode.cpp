@@ -1,8 +1,13 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NetworkCompulsoryGameMode.h"
+#include "ReplaySpectatorPlayerController.h"
 
 ANetworkCompulsoryGameMode::ANetworkCompulsoryGameMode()
 {
-	// stub
+	// keep players connected when the server changes maps
+	bUseSeamlessTravel = true;
+
+	// spectate recorded matches with the scrubbing replay controller
+	ReplaySpectatorPlayerControllerClass = AReplaySpectatorPlayerController::StaticClass();
 }
@@ -7,6 +7,7 @@
 #include "InputMappingContext.h"
 #include "Blueprint/UserWidget.h"
 #include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
 void ANetworkCompulsoryPlayerController::BeginPlay()
@@ -17,6 +18,7 @@ void ANetworkCompulsoryPlayerController::BeginPlay()
 	if (SVirtualJoystick::ShouldDisplayTouchInterface() && IsLocalPlayerController())
 	{
 		// spawn the mobile controls widget
+		LLM_SCOPE_BYTAG(NCUI);
 		MobileControlsWidget = CreateWidget<UUserWidget>(this, MobileControlsWidgetClass);
 
 		if (MobileControlsWidget)
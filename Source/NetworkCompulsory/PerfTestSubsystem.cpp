@@ -0,0 +1,311 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PerfTestSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Misc/App.h"
+#include "HAL/PlatformMemory.h"
+#include "RenderCore.h"
+#include "RHI.h"
+#include "UObject/UObjectGlobals.h"
+#include "NetworkCompulsory.h"
+
+bool UPerfTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("NCPerfTest")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPerfTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// apply the command line overrides
+	FString MapsOverride;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("NCPerfMaps="), MapsOverride, false))
+	{
+		Maps.Reset();
+		MapsOverride.ParseIntoArray(Maps, TEXT(","));
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("NCPerfDuration="), CaptureDuration);
+
+	bRecordBaselines = FParse::Param(FCommandLine::Get(), TEXT("NCPerfRecordBaselines"));
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: %d maps, %.0fs each%s"), Maps.Num(), CaptureDuration, bRecordBaselines ? TEXT(", recording baselines") : TEXT(""));
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UPerfTestSubsystem::OnPostLoadMap);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UPerfTestSubsystem::Tick));
+}
+
+void UPerfTestSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	Super::Deinitialize();
+}
+
+void UPerfTestSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	// the startup map loads first, so move on to the first test map
+	if (CurrentMapIndex == INDEX_NONE)
+	{
+		OpenNextMap();
+		return;
+	}
+
+	// start measuring the test map
+	Samples.Reset();
+	MapTime = 0.0f;
+	bCapturing = true;
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: capturing %s"), *Maps[CurrentMapIndex]);
+}
+
+bool UPerfTestSubsystem::Tick(float DeltaTime)
+{
+	if (!bCapturing)
+	{
+		return true;
+	}
+
+	UWorld* World = GetGameInstance()->GetWorld();
+
+	if (!World)
+	{
+		return true;
+	}
+
+	MapTime += DeltaTime;
+
+	DriveScriptedPath(World, DeltaTime);
+
+	// skip the warmup period so loading hitches don't skew the results
+	if (MapTime >= WarmupTime)
+	{
+		RecordSample(World);
+	}
+
+	// have we captured enough?
+	if (MapTime >= WarmupTime + CaptureDuration)
+	{
+		FinishMap();
+		OpenNextMap();
+	}
+
+	return true;
+}
+
+void UPerfTestSubsystem::DriveScriptedPath(UWorld* World, float DeltaTime)
+{
+	APlayerController* PC = World->GetFirstPlayerController();
+
+	if (!PC)
+	{
+		return;
+	}
+
+	// sweep the camera around at a constant rate
+	FRotator ControlRotation = PC->GetControlRotation();
+	ControlRotation.Yaw += CameraYawRate * DeltaTime;
+	PC->SetControlRotation(ControlRotation);
+
+	// walk the pawn around a closed loop so every run covers the same ground
+	if (APawn* Pawn = PC->GetPawn())
+	{
+		const float Angle = (MapTime / FMath::Max(PathLapTime, 0.1f)) * UE_TWO_PI;
+		const FVector Direction(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+
+		Pawn->AddMovementInput(Direction, 1.0f);
+	}
+}
+
+void UPerfTestSubsystem::RecordSample(UWorld* World)
+{
+	FPerfTestSample& Sample = Samples.AddDefaulted_GetRef();
+
+	Sample.Time = MapTime - WarmupTime;
+	Sample.FrameMs = float(FApp::GetDeltaTime() * 1000.0);
+	Sample.GameThreadMs = float(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	Sample.DrawCalls = GNumDrawCallsRHI[0];
+	Sample.MemoryMB = float(double(FPlatformMemory::GetStats().UsedPhysical) / (1024.0 * 1024.0));
+
+	// net stats are only available while we have a net driver
+	if (const UNetDriver* NetDriver = World->GetNetDriver())
+	{
+		Sample.NetInKBps = NetDriver->InBytesPerSecond / 1024.0f;
+		Sample.NetOutKBps = NetDriver->OutBytesPerSecond / 1024.0f;
+	}
+}
+
+void UPerfTestSubsystem::FinishMap()
+{
+	bCapturing = false;
+
+	const FString MapName = FPackageName::GetShortName(Maps[CurrentMapIndex]);
+
+	WriteCSV(MapName);
+
+	const FPerfTestBaseline Summary = Summarize(FName(*MapName));
+
+	// log the summary in baseline format so it can be pasted into the config
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: +Baselines=(Map=\"%s\",AvgFrameMs=%.3f,P95FrameMs=%.3f,AvgGameThreadMs=%.3f,AvgDrawCalls=%.1f,PeakMemoryMB=%.1f,AvgNetOutKBps=%.3f)"),
+		*MapName, Summary.AvgFrameMs, Summary.P95FrameMs, Summary.AvgGameThreadMs, Summary.AvgDrawCalls, Summary.PeakMemoryMB, Summary.AvgNetOutKBps);
+
+	if (bRecordBaselines)
+	{
+		RecordBaseline(Summary);
+
+	} else if (!CompareToBaseline(Summary)) {
+
+		bRegressed = true;
+	}
+}
+
+void UPerfTestSubsystem::OpenNextMap()
+{
+	++CurrentMapIndex;
+
+	// was that the last map?
+	if (!Maps.IsValidIndex(CurrentMapIndex))
+	{
+		if (bRecordBaselines)
+		{
+			// drop the command line overrides so only the baselines change in the config
+			const UPerfTestSubsystem* Defaults = GetDefault<UPerfTestSubsystem>();
+			Maps = Defaults->Maps;
+			CaptureDuration = Defaults->CaptureDuration;
+
+			// write the new baselines back to DefaultGame.ini so they can be committed
+			if (!TryUpdateDefaultConfigFile())
+			{
+				UE_LOG(LogNetworkCompulsory, Error, TEXT("Perf test: could not write the baselines to %s"), *GetDefaultConfigFilename());
+				bRegressed = true;
+			}
+
+			UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: %s"), bRegressed ? TEXT("FAILED") : TEXT("recorded new baselines"));
+
+		} else {
+
+			UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: %s"), bRegressed ? TEXT("FAILED") : TEXT("passed"));
+		}
+
+		FPlatformMisc::RequestExitWithStatus(false, bRegressed ? 1 : 0);
+		return;
+	}
+
+	// open the map as a listen server so net stats are captured too
+	UGameplayStatics::OpenLevel(GetGameInstance()->GetWorld(), FName(*Maps[CurrentMapIndex]), true, TEXT("listen"));
+}
+
+void UPerfTestSubsystem::WriteCSV(const FString& MapName) const
+{
+	FString CSV = TEXT("Time,FrameMs,GameThreadMs,DrawCalls,MemoryMB,NetInKBps,NetOutKBps\n");
+
+	for (const FPerfTestSample& Sample : Samples)
+	{
+		CSV += FString::Printf(TEXT("%.3f,%.3f,%.3f,%d,%.1f,%.3f,%.3f\n"),
+			Sample.Time, Sample.FrameMs, Sample.GameThreadMs, Sample.DrawCalls, Sample.MemoryMB, Sample.NetInKBps, Sample.NetOutKBps);
+	}
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("PerfTest") / (MapName + TEXT(".csv"));
+
+	if (!FFileHelper::SaveStringToFile(CSV, *Path))
+	{
+		UE_LOG(LogNetworkCompulsory, Error, TEXT("Perf test: could not write %s"), *Path);
+	}
+}
+
+FPerfTestBaseline UPerfTestSubsystem::Summarize(FName MapName) const
+{
+	FPerfTestBaseline Summary;
+	Summary.Map = MapName;
+
+	if (Samples.IsEmpty())
+	{
+		return Summary;
+	}
+
+	TArray<float> FrameTimes;
+	FrameTimes.Reserve(Samples.Num());
+
+	for (const FPerfTestSample& Sample : Samples)
+	{
+		FrameTimes.Add(Sample.FrameMs);
+
+		Summary.AvgFrameMs += Sample.FrameMs;
+		Summary.AvgGameThreadMs += Sample.GameThreadMs;
+		Summary.AvgDrawCalls += Sample.DrawCalls;
+		Summary.AvgNetOutKBps += Sample.NetOutKBps;
+		Summary.PeakMemoryMB = FMath::Max(Summary.PeakMemoryMB, Sample.MemoryMB);
+	}
+
+	const float NumSamples = float(Samples.Num());
+
+	Summary.AvgFrameMs /= NumSamples;
+	Summary.AvgGameThreadMs /= NumSamples;
+	Summary.AvgDrawCalls /= NumSamples;
+	Summary.AvgNetOutKBps /= NumSamples;
+
+	FrameTimes.Sort();
+	Summary.P95FrameMs = FrameTimes[FMath::Min(FMath::FloorToInt32(NumSamples * 0.95f), FrameTimes.Num() - 1)];
+
+	return Summary;
+}
+
+bool UPerfTestSubsystem::CompareToBaseline(const FPerfTestBaseline& Summary) const
+{
+	const FPerfTestBaseline* Baseline = Baselines.FindByPredicate([&Summary](const FPerfTestBaseline& Entry) { return Entry.Map == Summary.Map; });
+
+	// a map without a baseline can't be gated, so treat it as a failure rather than a silent pass
+	if (!Baseline)
+	{
+		UE_LOG(LogNetworkCompulsory, Error, TEXT("Perf test: no baseline for %s. Run with -NCPerfRecordBaselines to record one"), *Summary.Map.ToString());
+		return false;
+	}
+
+	bool bPassed = true;
+
+	// metrics without a baseline value are skipped
+	auto CheckMetric = [this, &Summary, &bPassed](const TCHAR* Name, float Current, float Stored)
+	{
+		if (Stored > 0.0f && Current > Stored * (1.0f + RegressionTolerance))
+		{
+			UE_LOG(LogNetworkCompulsory, Error, TEXT("Perf test: %s %s regressed: %.3f vs baseline %.3f"), *Summary.Map.ToString(), Name, Current, Stored);
+			bPassed = false;
+		}
+	};
+
+	CheckMetric(TEXT("AvgFrameMs"), Summary.AvgFrameMs, Baseline->AvgFrameMs);
+	CheckMetric(TEXT("P95FrameMs"), Summary.P95FrameMs, Baseline->P95FrameMs);
+	CheckMetric(TEXT("AvgGameThreadMs"), Summary.AvgGameThreadMs, Baseline->AvgGameThreadMs);
+	CheckMetric(TEXT("AvgDrawCalls"), Summary.AvgDrawCalls, Baseline->AvgDrawCalls);
+	CheckMetric(TEXT("PeakMemoryMB"), Summary.PeakMemoryMB, Baseline->PeakMemoryMB);
+	CheckMetric(TEXT("AvgNetOutKBps"), Summary.AvgNetOutKBps, Baseline->AvgNetOutKBps);
+
+	return bPassed;
+}
+
+void UPerfTestSubsystem::RecordBaseline(const FPerfTestBaseline& Summary)
+{
+	if (FPerfTestBaseline* Baseline = Baselines.FindByPredicate([&Summary](const FPerfTestBaseline& Entry) { return Entry.Map == Summary.Map; }))
+	{
+		*Baseline = Summary;
+
+	} else {
+
+		Baselines.Add(Summary);
+	}
+
+	UE_LOG(LogNetworkCompulsory, Display, TEXT("Perf test: recorded new baseline for %s"), *Summary.Map.ToString());
+}
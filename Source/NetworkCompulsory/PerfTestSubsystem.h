@@ -0,0 +1,167 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "PerfTestSubsystem.generated.h"
+
+/**
+ *  Stored performance baseline for a single map
+ */
+USTRUCT()
+struct FPerfTestBaseline
+{
+	GENERATED_BODY()
+
+	/** Short name of the map this baseline belongs to */
+	UPROPERTY(Config)
+	FName Map;
+
+	/** Average frame time */
+	UPROPERTY(Config)
+	float AvgFrameMs = 0.0f;
+
+	/** 95th percentile frame time */
+	UPROPERTY(Config)
+	float P95FrameMs = 0.0f;
+
+	/** Average game thread time */
+	UPROPERTY(Config)
+	float AvgGameThreadMs = 0.0f;
+
+	/** Average draw calls per frame */
+	UPROPERTY(Config)
+	float AvgDrawCalls = 0.0f;
+
+	/** Peak physical memory used by the process */
+	UPROPERTY(Config)
+	float PeakMemoryMB = 0.0f;
+
+	/** Average outgoing network bandwidth */
+	UPROPERTY(Config)
+	float AvgNetOutKBps = 0.0f;
+};
+
+/**
+ *  Command line performance test mode.
+ *  Launch the game with -NCPerfTest to load every test map in turn, drive the first player along a scripted path
+ *  while sweeping the camera, and write per-frame frame time, game thread time, draw calls, memory and net stats to CSV.
+ *  Each map's results are compared against the stored baselines. The process exits with a non-zero code if any map regresses
+ *  or has no baseline.
+ *  Maps are opened as listen servers with no clients connected, so the net columns only show the server's own traffic and stay near zero.
+ *  Optional arguments: -NCPerfMaps=MapA,MapB overrides the map list, -NCPerfDuration=Seconds overrides the capture length,
+ *  -NCPerfRecordBaselines records the results as the new baselines in DefaultGame.ini instead of comparing against them.
+ */
+UCLASS(config=Game)
+class UPerfTestSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Maps to test, in order */
+	UPROPERTY(Config)
+	TArray<FString> Maps;
+
+	/** Time to let each map settle before sampling */
+	UPROPERTY(Config)
+	float WarmupTime = 3.0f;
+
+	/** Time to sample each map for */
+	UPROPERTY(Config)
+	float CaptureDuration = 30.0f;
+
+	/** Yaw rate of the scripted camera sweep */
+	UPROPERTY(Config)
+	float CameraYawRate = 45.0f;
+
+	/** Time for the scripted bot to complete one lap of its path */
+	UPROPERTY(Config)
+	float PathLapTime = 8.0f;
+
+	/** Fraction a metric may exceed its baseline by before the run fails */
+	UPROPERTY(Config)
+	float RegressionTolerance = 0.1f;
+
+	/** Stored baselines, one per map */
+	UPROPERTY(Config)
+	TArray<FPerfTestBaseline> Baselines;
+
+	/** A single frame sample */
+	struct FPerfTestSample
+	{
+		float Time = 0.0f;
+		float FrameMs = 0.0f;
+		float GameThreadMs = 0.0f;
+		int32 DrawCalls = 0;
+		float MemoryMB = 0.0f;
+		float NetInKBps = 0.0f;
+		float NetOutKBps = 0.0f;
+	};
+
+	/** Samples captured on the current map */
+	TArray<FPerfTestSample> Samples;
+
+	/** Index of the map currently being tested. INDEX_NONE until the first test map is opened */
+	int32 CurrentMapIndex = INDEX_NONE;
+
+	/** Time since the current map was loaded */
+	float MapTime = 0.0f;
+
+	/** If true, the current map is loaded and being measured */
+	bool bCapturing = false;
+
+	/** If true, at least one map regressed against its baseline */
+	bool bRegressed = false;
+
+	/** If true, results are recorded as the new baselines instead of being compared */
+	bool bRecordBaselines = false;
+
+	/** Ticker handle */
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+	/** Only create the subsystem when the perf test is requested on the command line */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Starts capturing once a test map has loaded */
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/** Drives the scripted path and records samples */
+	bool Tick(float DeltaTime);
+
+	/** Moves the first local player along the scripted path and sweeps its camera */
+	void DriveScriptedPath(UWorld* World, float DeltaTime);
+
+	/** Records a sample for the current frame */
+	void RecordSample(UWorld* World);
+
+	/** Writes the current map's results and compares them against the baseline */
+	void FinishMap();
+
+	/** Opens the next test map, or ends the run after the last one */
+	void OpenNextMap();
+
+	/** Writes the CSV for the provided map */
+	void WriteCSV(const FString& MapName) const;
+
+	/** Builds a summary of the current samples */
+	FPerfTestBaseline Summarize(FName MapName) const;
+
+	/** Compares the summary against the stored baseline. Returns false if it regressed or there is no baseline */
+	bool CompareToBaseline(const FPerfTestBaseline& Summary) const;
+
+	/** Stores the summary as the baseline for its map, replacing any previous one */
+	void RecordBaseline(const FPerfTestBaseline& Summary);
+};
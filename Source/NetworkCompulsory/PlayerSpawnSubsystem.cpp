@@ -0,0 +1,227 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PlayerSpawnSubsystem.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "EngineUtils.h"
+
+bool UPlayerSpawnSubsystem::FindSpawnTransform(const AController* Controller, ESpawnPointPolicy Policy, const FVector& Origin, FTransform& OutTransform)
+{
+	// checkpoints always take precedence
+	if (const FTransform* Checkpoint = Checkpoints.Find(Controller))
+	{
+		OutTransform = *Checkpoint;
+		return true;
+	}
+
+	// drop any spawn points that have been destroyed
+	SpawnPoints.RemoveAll([](const TWeakObjectPtr<APlayerStart>& SpawnPoint) { return !SpawnPoint.IsValid(); });
+
+	if (SpawnPoints.Num() == 0)
+	{
+		return false;
+	}
+
+	const APlayerStart* BestSpawnPoint = nullptr;
+
+	switch (Policy)
+	{
+	case ESpawnPointPolicy::First:
+
+		BestSpawnPoint = SpawnPoints[0].Get();
+		break;
+
+	case ESpawnPointPolicy::RoundRobin:
+
+		RoundRobinIndex = RoundRobinIndex % SpawnPoints.Num();
+		BestSpawnPoint = SpawnPoints[RoundRobinIndex++].Get();
+		break;
+
+	case ESpawnPointPolicy::NearestFree:
+	{
+		float BestDistance = TNumericLimits<float>::Max();
+
+		for (const TWeakObjectPtr<APlayerStart>& SpawnPoint : SpawnPoints)
+		{
+			const FVector Location = SpawnPoint->GetActorLocation();
+			const float Distance = FVector::DistSquared(Location, Origin);
+
+			if (Distance < BestDistance && !IsOccupied(Location, Controller))
+			{
+				BestDistance = Distance;
+				BestSpawnPoint = SpawnPoint.Get();
+			}
+		}
+
+		break;
+	}
+
+	case ESpawnPointPolicy::FarthestFromEnemies:
+	{
+		// gather the AI controlled pawns
+		TArray<FVector, TInlineAllocator<32>> EnemyLocations;
+
+		for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+		{
+			const AController* OtherController = It->Get();
+
+			if (OtherController && !OtherController->IsPlayerController() && OtherController->GetPawn())
+			{
+				EnemyLocations.Add(OtherController->GetPawn()->GetActorLocation());
+			}
+		}
+
+		float BestDistance = -1.0f;
+
+		for (const TWeakObjectPtr<APlayerStart>& SpawnPoint : SpawnPoints)
+		{
+			const FVector Location = SpawnPoint->GetActorLocation();
+
+			// find the distance to the closest enemy
+			float ClosestEnemy = TNumericLimits<float>::Max();
+
+			for (const FVector& EnemyLocation : EnemyLocations)
+			{
+				ClosestEnemy = FMath::Min(ClosestEnemy, FVector::DistSquared(Location, EnemyLocation));
+			}
+
+			if (ClosestEnemy > BestDistance)
+			{
+				BestDistance = ClosestEnemy;
+				BestSpawnPoint = SpawnPoint.Get();
+			}
+		}
+
+		break;
+	}
+	}
+
+	// every spawn point was occupied, fall back to the first one
+	if (!BestSpawnPoint)
+	{
+		BestSpawnPoint = SpawnPoints[0].Get();
+	}
+
+	OutTransform = BestSpawnPoint->GetActorTransform();
+
+	return true;
+}
+
+void UPlayerSpawnSubsystem::SetCheckpoint(const AController* Controller, const FTransform& Checkpoint)
+{
+	Checkpoints.Add(Controller, Checkpoint);
+}
+
+void UPlayerSpawnSubsystem::ClearCheckpoint(const AController* Controller)
+{
+	Checkpoints.Remove(Controller);
+}
+
+APawn* UPlayerSpawnSubsystem::SpawnPawn(TSubclassOf<APawn> PawnClass, const FTransform& SpawnTransform)
+{
+	if (!PawnClass)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	return GetWorld()->SpawnActor<APawn>(PawnClass, SpawnTransform, SpawnParams);
+}
+
+void UPlayerSpawnSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// subscribe to streaming level changes
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UPlayerSpawnSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UPlayerSpawnSubsystem::OnLevelRemoved);
+}
+
+void UPlayerSpawnSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	SpawnPoints.Empty();
+	Checkpoints.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPlayerSpawnSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// index the persistent level and any levels that were already loaded
+	for (const ULevel* Level : InWorld.GetLevels())
+	{
+		IndexLevel(Level);
+	}
+}
+
+bool UPlayerSpawnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPlayerSpawnSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == GetWorld())
+	{
+		IndexLevel(Level);
+	}
+}
+
+void UPlayerSpawnSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// a null level means every level is being removed
+	SpawnPoints.RemoveAll([Level](const TWeakObjectPtr<APlayerStart>& SpawnPoint)
+	{
+		return !SpawnPoint.IsValid() || !Level || SpawnPoint->GetLevel() == Level;
+	});
+}
+
+void UPlayerSpawnSubsystem::IndexLevel(const ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (APlayerStart* SpawnPoint = Cast<APlayerStart>(Actor))
+		{
+			SpawnPoints.AddUnique(SpawnPoint);
+		}
+	}
+}
+
+bool UPlayerSpawnSubsystem::IsOccupied(const FVector& Location, const AController* IgnoreController) const
+{
+	const float OccupiedRadiusSquared = OccupiedRadius * OccupiedRadius;
+
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		const AController* OtherController = It->Get();
+		const APawn* Pawn = OtherController && OtherController != IgnoreController ? OtherController->GetPawn() : nullptr;
+
+		if (Pawn && FVector::DistSquared(Pawn->GetActorLocation(), Location) <= OccupiedRadiusSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
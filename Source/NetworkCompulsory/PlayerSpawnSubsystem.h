@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlayerSpawnSubsystem.generated.h"
+
+class APlayerStart;
+class AController;
+
+/**
+ *  Policy used to choose a spawn point
+ */
+UENUM(BlueprintType)
+enum class ESpawnPointPolicy : uint8
+{
+	/** Always use the first spawn point in the level */
+	First,
+
+	/** Use the spawn point nearest to the death location that isn't occupied by another pawn */
+	NearestFree,
+
+	/** Cycle through all spawn points */
+	RoundRobin,
+
+	/** Use the spawn point farthest away from the closest AI controlled pawn */
+	FarthestFromEnemies
+};
+
+/**
+ *  Indexes player spawn points so respawning never has to scan the world.
+ *  - Player starts are indexed when the world begins play and when streaming levels are added or removed
+ *  - Controllers can override their spawn point with a checkpoint
+ *  - Spawns a replacement pawn when a character was destroyed instead of being reset in place
+ */
+UCLASS(config=Game)
+class UPlayerSpawnSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max distance from another pawn at which a spawn point is considered occupied */
+	UPROPERTY(Config, EditAnywhere, Category="Spawning", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float OccupiedRadius = 100.0f;
+
+	/** Indexed spawn points */
+	TArray<TWeakObjectPtr<APlayerStart>> SpawnPoints;
+
+	/** Checkpoint overrides per controller */
+	TMap<TWeakObjectPtr<const AController>, FTransform> Checkpoints;
+
+	/** Next spawn point to use with the round robin policy */
+	int32 RoundRobinIndex = 0;
+
+	/** Streaming level delegate handles */
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+public:
+
+	/** Finds the best spawn transform for a controller. Returns the controller's checkpoint if it has one */
+	bool FindSpawnTransform(const AController* Controller, ESpawnPointPolicy Policy, const FVector& Origin, FTransform& OutTransform);
+
+	/** Sets a checkpoint that overrides the spawn points for the provided controller */
+	void SetCheckpoint(const AController* Controller, const FTransform& Checkpoint);
+
+	/** Removes the checkpoint for the provided controller */
+	void ClearCheckpoint(const AController* Controller);
+
+	/** Spawns a pawn of the provided class at the spawn transform, nudging it out of any blocking geometry */
+	APawn* SpawnPawn(TSubclassOf<APawn> PawnClass, const FTransform& SpawnTransform);
+
+	/** Returns the number of indexed spawn points */
+	int32 GetNumSpawnPoints() const { return SpawnPoints.Num(); }
+
+	/** Initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	/** Indexes the spawn points in the persistent level */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Indexes the spawn points in a streamed in level */
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	/** Removes the spawn points in a streamed out level */
+	void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+
+	/** Adds all player starts in the level to the index */
+	void IndexLevel(const ULevel* Level);
+
+	/** Returns true if another pawn is standing close to the location. The requesting controller's own pawn is ignored, since it may be respawned in place */
+	bool IsOccupied(const FVector& Location, const AController* IgnoreController) const;
+};
@@ -8,6 +8,8 @@
 	#include "Particles/ParticleSystem.h"
 	#include "Kismet/GameplayStatics.h"
 	#include "UObject/ConstructorHelpers.h"
+	#include "NetworkCompulsory.h"
+	#include "MemoryBudgetSubsystem.h"
 
 	// Sets default values
 	AProjectile::AProjectile()
@@ -74,12 +76,18 @@
 
 	void AProjectile::Destroyed()
 	{
+		NetworkCompulsoryHitch::RecordEvent(TEXT("ExplosionVFX"), this);
+		LLM_SCOPE_BYTAG(NCVFX);
+
 		FVector spawnLocation = GetActorLocation();
 		UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionEffect, spawnLocation, FRotator::ZeroRotator, true, EPSCPoolMethod::AutoRelease);
 	}
 
 	void AProjectile::OnProjectileImpact(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 	{
+		NC_SCOPE_CYCLE_COUNTER(STAT_NC_ProjectileImpact);
+		INC_DWORD_STAT(STAT_NC_NumProjectileImpacts);
+
 		if (OtherActor)
 		{
 			UGameplayStatics::ApplyPointDamage(OtherActor, Damage, NormalImpulse, Hit, GetInstigator()->Controller, this, DamageType);
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ReplaySpectatorPlayerController.h"
+#include "Engine/World.h"
+#include "Engine/DemoNetDriver.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ReplaySpectator
+{
+	/** Returns the replay spectator for the world, if it's playing back a replay */
+	static AReplaySpectatorPlayerController* GetSpectator(UWorld* World)
+	{
+		return World && World->IsPlayingReplay() ? Cast<AReplaySpectatorPlayerController>(World->GetFirstPlayerController()) : nullptr;
+	}
+
+	/** Jumps to a replay time */
+	static FAutoConsoleCommandWithWorldAndArgs SeekCommand(
+		TEXT("nc.Replay.Seek"),
+		TEXT("Jumps to the provided time in seconds in the replay being played back"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (AReplaySpectatorPlayerController* Spectator = GetSpectator(World))
+			{
+				Spectator->SeekTo(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.0f);
+			}
+		})
+	);
+
+	/** Jumps relative to the current replay time */
+	static FAutoConsoleCommandWithWorldAndArgs SkipCommand(
+		TEXT("nc.Replay.Skip"),
+		TEXT("Jumps forward, or backward if negative, by the provided seconds in the replay being played back"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (AReplaySpectatorPlayerController* Spectator = GetSpectator(World))
+			{
+				Spectator->SkipBy(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.0f);
+			}
+		})
+	);
+
+	/** Toggles replay pause */
+	static FAutoConsoleCommandWithWorld PauseCommand(
+		TEXT("nc.Replay.Pause"),
+		TEXT("Pauses or resumes the replay being played back"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (AReplaySpectatorPlayerController* Spectator = GetSpectator(World))
+			{
+				Spectator->SetReplayPaused(!Spectator->IsReplayPaused());
+			}
+		})
+	);
+
+	/** Changes the replay speed */
+	static FAutoConsoleCommandWithWorldAndArgs SpeedCommand(
+		TEXT("nc.Replay.Speed"),
+		TEXT("Sets the playback speed multiplier of the replay being played back"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (AReplaySpectatorPlayerController* Spectator = GetSpectator(World))
+			{
+				Spectator->SetPlaybackSpeed(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 1.0f);
+			}
+		})
+	);
+}
+
+AReplaySpectatorPlayerController::AReplaySpectatorPlayerController()
+{
+	// keep ticking while the replay is paused so we can resume it
+	bShouldPerformFullTickWhenPaused = true;
+	bShowMouseCursor = true;
+}
+
+void AReplaySpectatorPlayerController::SeekTo(float Seconds)
+{
+	if (UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver())
+	{
+		DemoDriver->GotoTimeInSeconds(FMath::Clamp(Seconds, 0.0f, DemoDriver->GetDemoTotalTime()));
+	}
+}
+
+void AReplaySpectatorPlayerController::SkipBy(float Seconds)
+{
+	SeekTo(GetReplayTime() + Seconds);
+}
+
+void AReplaySpectatorPlayerController::SetReplayPaused(bool bPaused)
+{
+	// replays pause through the world settings pauser, like regular games
+	if (AWorldSettings* WorldSettings = GetWorldSettings())
+	{
+		WorldSettings->SetPauserPlayerState(bPaused ? PlayerState.Get() : nullptr);
+	}
+}
+
+bool AReplaySpectatorPlayerController::IsReplayPaused() const
+{
+	const AWorldSettings* WorldSettings = GetWorldSettings();
+
+	return WorldSettings && WorldSettings->GetPauserPlayerState() != nullptr;
+}
+
+void AReplaySpectatorPlayerController::SetPlaybackSpeed(float Speed)
+{
+	if (AWorldSettings* WorldSettings = GetWorldSettings())
+	{
+		WorldSettings->DemoPlayTimeDilation = FMath::Clamp(Speed, 0.1f, 8.0f);
+	}
+}
+
+float AReplaySpectatorPlayerController::GetReplayTime() const
+{
+	const UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+
+	return DemoDriver ? DemoDriver->GetDemoCurrentTime() : 0.0f;
+}
+
+float AReplaySpectatorPlayerController::GetReplayDuration() const
+{
+	const UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+
+	return DemoDriver ? DemoDriver->GetDemoTotalTime() : 0.0f;
+}
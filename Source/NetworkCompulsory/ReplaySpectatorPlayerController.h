@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "ReplaySpectatorPlayerController.generated.h"
+
+/**
+ *  Player controller spawned when playing back a recorded match.
+ *  Scrubs, pauses and changes the speed of the replay timeline.
+ *  Driven from Blueprint UI or the nc.Replay.Seek, nc.Replay.Skip, nc.Replay.Pause and nc.Replay.Speed commands
+ */
+UCLASS()
+class AReplaySpectatorPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	AReplaySpectatorPlayerController();
+
+	/** Jumps to the provided time in the replay */
+	UFUNCTION(BlueprintCallable, Category="Replay")
+	void SeekTo(float Seconds);
+
+	/** Jumps forward or backward from the current replay time */
+	UFUNCTION(BlueprintCallable, Category="Replay")
+	void SkipBy(float Seconds);
+
+	/** Pauses or resumes playback */
+	UFUNCTION(BlueprintCallable, Category="Replay")
+	void SetReplayPaused(bool bPaused);
+
+	/** Returns true if playback is paused */
+	UFUNCTION(BlueprintPure, Category="Replay")
+	bool IsReplayPaused() const;
+
+	/** Sets the playback speed multiplier */
+	UFUNCTION(BlueprintCallable, Category="Replay")
+	void SetPlaybackSpeed(float Speed);
+
+	/** Returns the current replay time */
+	UFUNCTION(BlueprintPure, Category="Replay")
+	float GetReplayTime() const;
+
+	/** Returns the total length of the replay */
+	UFUNCTION(BlueprintPure, Category="Replay")
+	float GetReplayDuration() const;
+};
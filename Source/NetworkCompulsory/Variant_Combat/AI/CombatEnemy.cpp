@@ -8,9 +8,13 @@
 #include "Components/WidgetComponent.h"
 #include "Engine/DamageEvents.h"
 #include "CombatLifeBar.h"
-#include "TimerManager.h"
+#include "CombatCorpseSubsystem.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
+#include "CombatDamageSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 
 ACombatEnemy::ACombatEnemy()
 {
@@ -115,6 +119,16 @@ void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 
 void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_AttackTrace);
+
+	// AI attacks are only processed by the server
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_NC_NumAttackTraces);
+
 	// sweep for objects in front of the character to be hit by the attack
 	TArray<FHitResult> OutHits;
 
@@ -150,8 +164,11 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 					// knock upwards and away from the impact normal
 					const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
 
-					// pass the damage event to the actor
-					Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+					// queue the damage event so it's applied along with the rest of the frame's damage
+					if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
+					{
+						DamageSubsystem->QueueDamage(CurrentHit.GetActor(), MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+					}
 
 				}
 			}
@@ -187,9 +204,72 @@ void ACombatEnemy::CheckChargedAttack()
 	}
 }
 
+void ACombatEnemy::UpdateLifeBar()
+{
+	// the widget may not exist yet if HP replicates before BeginPlay
+	if (LifeBarWidget)
+	{
+		// show the predicted HP so attacking clients get immediate feedback
+		LifeBarWidget->SetLifePercentage(FMath::Max(CurrentHP - PredictedDamage, 0.0f) / MaxHP);
+	}
+}
+
+void ACombatEnemy::PlayDamageReaction(float Damage, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// is the character still alive?
+	if (CurrentHP > 0.0f)
+	{
+		// enable partial ragdoll physics, but keep the pelvis vertical
+		GetMesh()->SetPhysicsBlendWeight(0.5f);
+		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+	}
+
+	// is the character ragdolling?
+	if (GetMesh()->IsSimulatingPhysics())
+	{
+		// apply an impulse to the ragdoll
+		GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+	}
+
+	// stop the attack montages to interrupt the attack
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
+		AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+	}
+
+	// pass control to BP to play effects, etc.
+	ReceivedDamage(Damage, DamageLocation, DamageImpulse.GetSafeNormal());
+}
+
+void ACombatEnemy::OnRep_CurrentHP()
+{
+	// the server's HP is authoritative, so drop any pending prediction
+	PredictedDamage = 0.0f;
+
+	// have we run out of HP?
+	if (CurrentHP <= 0.0f)
+	{
+		// die
+		HandleDeath();
+
+	} else {
+
+		// update the life bar
+		UpdateLifeBar();
+	}
+}
+
 void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
-	
+	// damage is only applied by the server. Clients go through ApplyPredictedDamage instead
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	NetworkCompulsoryHitch::RecordEvent(TEXT("ApplyDamage"), this);
+
 	// pass the damage event to the actor
 	FDamageEvent DamageEvent;
 	const float ActualDamage = TakeDamage(Damage, DamageEvent, nullptr, DamageCauser);
@@ -200,22 +280,14 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 		// apply the knockback impulse
 		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
-		// is the character ragdolling?
-		if (GetMesh()->IsSimulatingPhysics())
-		{
-			// apply an impulse to the ragdoll
-			GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
-		}
+		// play the reaction on the server
+		PlayDamageReaction(ActualDamage, DamageLocation, DamageImpulse);
 
-		// stop the attack montages to interrupt the attack
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+		// and on any clients that didn't predict it
+		if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
 		{
-			AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
-			AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+			DamageSubsystem->AddConfirmedEvent(this, ActualDamage, DamageCauser, DamageLocation, DamageImpulse);
 		}
-
-		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
 	}
 }
 
@@ -236,8 +308,11 @@ void ACombatEnemy::HandleDeath()
 	// call the died delegate to notify any subscribers
 	OnEnemyDied.Broadcast();
 
-	// set up the death timer
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatEnemy::RemoveFromLevel, DeathRemovalTime);
+	// hand the ragdoll over to the corpse manager so it can be put to sleep and removed later
+	if (UCombatCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UCombatCorpseSubsystem>())
+	{
+		Corpses->RegisterCorpse(this, GetMesh(), DeathRemovalTime);
+	}
 }
 
 void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
@@ -245,16 +320,41 @@ void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
-void ACombatEnemy::RemoveFromLevel()
+void ACombatEnemy::ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// ignore if we're already predicted to be dead. Death itself always waits for the server
+	if (CurrentHP - PredictedDamage <= 0.0f)
+	{
+		return;
+	}
+
+	// accumulate the predicted damage and update the life bar
+	PredictedDamage += Damage;
+
+	UpdateLifeBar();
+
+	// play the reaction
+	PlayDamageReaction(Damage, DamageLocation, DamageImpulse);
+}
+
+void ACombatEnemy::CancelPredictedDamage()
+{
+	// restore the life bar to the server's HP
+	PredictedDamage = 0.0f;
+
+	UpdateLifeBar();
+}
+
+void ACombatEnemy::PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
-	// destroy this actor
-	Destroy();
+	// play the reaction
+	PlayDamageReaction(Damage, DamageLocation, DamageImpulse);
 }
 
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	// only process damage on the server, and only if the character is still alive
+	if (!HasAuthority() || CurrentHP <= 0.0f)
 	{
 		return 0.0f;
 	}
@@ -271,11 +371,7 @@ float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEv
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
-
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		UpdateLifeBar();
 	}
 
 	// return the received damage amount
@@ -299,24 +395,34 @@ void ACombatEnemy::Landed(const FHitResult& Hit)
 
 void ACombatEnemy::BeginPlay()
 {
-	// reset HP to maximum
-	CurrentHP = MaxHP;
+	// reset HP to maximum. Clients receive their HP through replication
+	if (HasAuthority())
+	{
+		CurrentHP = MaxHP;
+	}
+
+	// create the life bar widget up front so it's tracked under the UI memory tag
+	{
+		LLM_SCOPE_BYTAG(NCUI);
+		LifeBar->InitWidget();
+	}
 
 	// we top the HP before BeginPlay so StateTree picks it up at the right value
 	Super::BeginPlay();
 
 	// get the life bar widget from the widget comp
 	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
+	NetworkCompulsoryHitch::RecordEvent(TEXT("CreateLifeBar"), this);
 	check(LifeBarWidget);
 
 	// fill the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	UpdateLifeBar();
 }
 
-void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
+void ACombatEnemy::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	Super::EndPlay(EndPlayReason);
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	// clear the death timer
-	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+	// replicate the current HP
+	DOREPLIFETIME(ACombatEnemy, CurrentHP);
 }
@@ -7,7 +7,6 @@
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
 #include "Animation/AnimMontage.h"
-#include "Engine/TimerHandle.h"
 #include "CombatEnemy.generated.h"
 
 class UWidgetComponent;
@@ -26,6 +25,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyDied);
 /**
  *  An AI-controlled character with combat capabilities.
  *  Its bundled AI Controller runs logic through StateTree
+ *  HP is owned by the server. Clients may predict hit reactions until the server confirms them
  */
 UCLASS(abstract)
 class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable
@@ -49,12 +49,15 @@ protected:
 
 public:
 
-	/** Current amount of HP the character has */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
+	/** Current amount of HP the character has. Only modified by the server */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_CurrentHP, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float CurrentHP = 0.0f;
 
 protected:
 
+	/** Damage predicted on this machine that hasn't been confirmed by the server yet */
+	float PredictedDamage = 0.0f;
+
 	/** Name of the pelvis bone, for damage ragdoll physics */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
@@ -130,9 +133,6 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Death")
 	float DeathRemovalTime = 5.0f;
 
-	/** Enemy death timer */
-	FTimerHandle DeathTimer;
-
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
@@ -158,6 +158,18 @@ public:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+protected:
+
+	/** Updates the life bar from the current and predicted HP */
+	void UpdateLifeBar();
+
+	/** Plays the ragdoll, attack interruption and effects reaction to a hit. Runs on every machine */
+	void PlayDamageReaction(float Damage, const FVector& DamageLocation, const FVector& DamageImpulse);
+
+	/** Handles HP replication */
+	UFUNCTION()
+	void OnRep_CurrentHP();
+
 public:
 
 	// ~begin ICombatAttacker interface
@@ -186,12 +198,16 @@ public:
 	/** Handles healing events */
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
-	// ~end ICombatDamageable interface
+	/** Plays damage reactions locally ahead of server confirmation */
+	virtual void ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
 
-protected:
+	/** Rolls back any predicted damage the server didn't confirm */
+	virtual void CancelPredictedDamage() override;
 
-	/** Removes this character from the level after it dies */
-	void RemoveFromLevel();
+	/** Plays a damage reaction confirmed by the server */
+	virtual void PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
+	// ~end ICombatDamageable interface
 
 public:
 
@@ -212,6 +228,6 @@ protected:
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
-	/** EndPlay cleanup */
-	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 };
@@ -5,8 +5,10 @@
 #include "Components/SceneComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/ArrowComponent.h"
-#include "TimerManager.h"
+#include "GameplayTimerSubsystem.h"
 #include "CombatEnemy.h"
+#include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
@@ -29,13 +31,18 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 
 void ACombatEnemySpawner::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(NCSpawners);
+
 	Super::BeginPlay();
 	
 	// should we spawn an enemy right away?
 	if (bShouldSpawnEnemiesImmediately)
 	{
 		// schedule the first enemy spawn
-		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
+		if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+		{
+			Timers->SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
+		}
 	}
 
 }
@@ -45,11 +52,22 @@ void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 
 	// clear the spawn timer
-	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(SpawnTimer);
+	}
 }
 
 void ACombatEnemySpawner::SpawnEnemy()
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_SpawnEnemy);
+
+	// enemies are spawned by the server and replicated to clients
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// ensure the enemy class is valid
 	if (IsValid(EnemyClass))
 	{
@@ -57,11 +75,15 @@ void ACombatEnemySpawner::SpawnEnemy()
 		FActorSpawnParameters SpawnParams;
 		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
 
+		LLM_SCOPE_BYTAG(NCEnemies);
 		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
 
 		// was the enemy successfully created?
 		if (SpawnedEnemy)
 		{
+			INC_DWORD_STAT(STAT_NC_NumEnemiesSpawned);
+			NetworkCompulsoryHitch::RecordEvent(TEXT("SpawnEnemy"), SpawnedEnemy);
+
 			// subscribe to the death delegate
 			SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
 		}
@@ -77,12 +99,18 @@ void ACombatEnemySpawner::OnEnemyDied()
 	if (SpawnCount <= 0)
 	{
 		// schedule the activation on depleted message
-		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnerDepleted, ActivationDelay);
+		if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+		{
+			Timers->SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnerDepleted, ActivationDelay);
+		}
 		return;
 	}
 
 	// schedule the next enemy spawn
-	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, RespawnDelay);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, RespawnDelay);
+	}
 }
 
 void ACombatEnemySpawner::SpawnerDepleted()
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "CombatActivatable.h"
+#include "GameplayTimerSubsystem.h"
 #include "CombatEnemySpawner.generated.h"
 
 class UCapsuleComponent;
@@ -62,7 +63,7 @@ protected:
 	bool bHasBeenActivated = false;
 
 	/** Timer to spawn enemies after a delay */
-	FTimerHandle SpawnTimer;
+	FGameplayTimerHandle SpawnTimer;
 
 public:	
 	
@@ -10,6 +10,7 @@
 #include "CombatEnemy.h"
 #include "Kismet/GameplayStatics.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "NetworkCompulsory.h"
 
 bool FStateTreeCharacterGroundedCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -263,6 +264,9 @@ FText FStateTreeSetCharacterSpeedTask::GetDescription(const FGuid& ID, FStateTre
 
 EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_StateTreeTaskTick);
+	INC_DWORD_STAT(STAT_NC_NumStateTreeTaskTicks);
+
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
@@ -12,9 +12,13 @@
 #include "EnhancedInputComponent.h"
 #include "CombatLifeBar.h"
 #include "Engine/DamageEvents.h"
-#include "TimerManager.h"
+#include "GameplayTimerSubsystem.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
+#include "CombatDamageSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 
 ACombatCharacter::ACombatCharacter()
 {
@@ -168,9 +172,191 @@ void ACombatCharacter::ResetHP()
 {
 	// reset the current HP total
 	CurrentHP = MaxHP;
+	PredictedDamage = 0.0f;
 
 	// update the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	UpdateLifeBar();
+}
+
+void ACombatCharacter::UpdateLifeBar()
+{
+	// the widget may not exist yet if HP replicates before BeginPlay
+	if (LifeBarWidget)
+	{
+		// show the predicted HP so the owning client gets immediate feedback
+		LifeBarWidget->SetLifePercentage(FMath::Max(CurrentHP - PredictedDamage, 0.0f) / MaxHP);
+	}
+}
+
+void ACombatCharacter::PlayDamageReaction(float Damage, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// is the character still alive?
+	if (CurrentHP > 0.0f)
+	{
+		// enable partial ragdoll physics, but keep the pelvis vertical
+		GetMesh()->SetPhysicsBlendWeight(0.5f);
+		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+	}
+
+	// is the character ragdolling?
+	if (GetMesh()->IsSimulatingPhysics())
+	{
+		// apply an impulse to the ragdoll
+		GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+	}
+
+	// pass control to BP to play effects, etc.
+	ReceivedDamage(Damage, DamageLocation, DamageImpulse.GetSafeNormal());
+}
+
+void ACombatCharacter::OnRep_CurrentHP(float OldHP)
+{
+	// the server's HP is authoritative, so drop any pending prediction
+	PredictedDamage = 0.0f;
+
+	// have we run out of HP?
+	if (CurrentHP <= 0.0f)
+	{
+		// die
+		HandleDeath();
+
+	} else {
+
+		// have we been respawned in place? Skip the initial replication, since we haven't died yet
+		if (OldHP <= 0.0f && HasActorBegunPlay())
+		{
+			RestoreFromDeath();
+		}
+
+		// update the life bar
+		UpdateLifeBar();
+	}
+}
+
+void ACombatCharacter::RestoreFromDeath()
+{
+	// disable ragdoll physics
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+
+	// reattach the mesh to the capsule and reset its transform
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeTransform(MeshStartingTransform);
+
+	// stop any attacks that were interrupted by death
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	bIsAttacking = false;
+	bIsChargingAttack = false;
+	bHasLoopedChargedAttack = false;
+	ComboCount = 0;
+
+	// show the life bar
+	LifeBar->SetHiddenInGame(false);
+
+	// reset the camera
+	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
+
+	// re-enable movement
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+}
+
+void ACombatCharacter::NotifySwingStarted()
+{
+	// the server runs its own traces, so only remote owning clients need a window
+	if (IsLocallyControlled() && !HasAuthority())
+	{
+		ServerStartSwing();
+	}
+}
+
+void ACombatCharacter::ServerStartSwing_Implementation()
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// ignore swings faster than any attack animation can play them
+	if (LastAttackWindowTime >= 0.0f && Now - LastAttackWindowTime < MinAttackInterval)
+	{
+		return;
+	}
+
+	LastAttackWindowTime = Now;
+	AttackWindowEndTime = Now + AttackWindowDuration;
+}
+
+void ACombatCharacter::ServerReportHits_Implementation(const TArray<FCombatHitReport>& Hits)
+{
+	TArray<AActor*> RejectedTargets;
+	TArray<AActor*> AcceptedTargets;
+
+	// only accept a single report for each swing the server has seen start
+	const bool bWindowOpen = GetWorld()->GetTimeSeconds() <= AttackWindowEndTime;
+
+	// close the window so a second batch for the same swing is rejected
+	AttackWindowEndTime = 0.0f;
+
+	// max distance from the character to the target's collision at which a legitimate hit can happen
+	const float MaxHitDistance = MeleeTraceDistance + MeleeTraceRadius + HitValidationTolerance + GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	// max knockback a legitimate hit can apply
+	const float MaxImpulse = FVector2D(MeleeKnockbackImpulse, MeleeLaunchImpulse).Size();
+
+	UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>();
+
+	for (const FCombatHitReport& Hit : Hits)
+	{
+		// ignore anything that can't be damaged
+		ICombatDamageable* Damageable = Cast<ICombatDamageable>(Hit.Target);
+
+		if (!Damageable || !DamageSubsystem || Hit.Target == this)
+		{
+			continue;
+		}
+
+		// measure the range to the target's server side collision, not the client reported impact point
+		const FBox TargetBounds = Hit.Target->GetComponentsBoundingBox();
+		const float TargetDistance = TargetBounds.IsValid
+			? FMath::Sqrt(TargetBounds.ComputeSquaredDistanceToPoint(GetActorLocation()))
+			: FVector::Dist(GetActorLocation(), Hit.Target->GetActorLocation());
+
+		// reject hits outside a swing, from dead characters, repeated or over budget, and out of melee range
+		if (!bWindowOpen || CurrentHP <= 0.0f || AcceptedTargets.Contains(Hit.Target) || AcceptedTargets.Num() >= MaxReportedHits || TargetDistance > MaxHitDistance)
+		{
+			RejectedTargets.AddUnique(Hit.Target);
+			continue;
+		}
+
+		AcceptedTargets.AddUnique(Hit.Target);
+
+		// queue the damage with server side values
+		DamageSubsystem->QueueDamage(Hit.Target, MeleeDamage, this, Hit.Location, FVector(Hit.Impulse).GetClampedToMaxSize(MaxImpulse));
+	}
+
+	// a target rejected as a duplicate was still hit once, so don't roll it back
+	for (AActor* Target : AcceptedTargets)
+	{
+		RejectedTargets.Remove(Target);
+	}
+
+	// let the client roll back its rejected predictions
+	if (RejectedTargets.Num() > 0)
+	{
+		ClientRejectHits(RejectedTargets);
+	}
+}
+
+void ACombatCharacter::ClientRejectHits_Implementation(const TArray<AActor*>& Targets)
+{
+	for (AActor* Target : Targets)
+	{
+		if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Target))
+		{
+			Damageable->CancelPredictedDamage();
+		}
+	}
 }
 
 void ACombatCharacter::ComboAttack()
@@ -181,6 +367,9 @@ void ACombatCharacter::ComboAttack()
 	// reset the combo count
 	ComboCount = 0;
 
+	// the first combo stage is a swing
+	NotifySwingStarted();
+
 	// play the attack montage
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
@@ -242,6 +431,18 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 
 void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_AttackTrace);
+
+	// only the server and the owning client process attacks
+	const bool bIsServer = HasAuthority();
+
+	if (!bIsServer && !IsLocallyControlled())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_NC_NumAttackTraces);
+
 	// sweep for objects in front of the character to be hit by the attack
 	TArray<FHitResult> OutHits;
 
@@ -262,6 +463,9 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
+	// hits predicted on the owning client, to be validated by the server
+	TArray<FCombatHitReport> PredictedHits;
+
 	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
 	{
 		// iterate over each object hit
@@ -275,14 +479,36 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 				// knock upwards and away from the impact normal
 				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
 
-				// pass the damage event to the actor
-				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+				if (bIsServer)
+				{
+					// queue the damage event so it's applied along with the rest of the frame's damage
+					if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
+					{
+						DamageSubsystem->QueueDamage(CurrentHit.GetActor(), MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+					}
+
+				} else {
+
+					// play the reaction right away and let the server confirm the hit
+					Damageable->ApplyPredictedDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+
+					FCombatHitReport& Report = PredictedHits.AddDefaulted_GetRef();
+					Report.Target = CurrentHit.GetActor();
+					Report.Location = CurrentHit.ImpactPoint;
+					Report.Impulse = Impulse;
+				}
 
 				// call the BP handler to play effects, etc.
 				DealtDamage(MeleeDamage, CurrentHit.ImpactPoint);
 			}
 		}
 	}
+
+	// send all predicted hits to the server in a single RPC
+	if (PredictedHits.Num() > 0)
+	{
+		ServerReportHits(PredictedHits);
+	}
 }
 
 void ACombatCharacter::CheckCombo()
@@ -307,6 +533,9 @@ void ACombatCharacter::CheckCombo()
 				{
 					AnimInstance->Montage_JumpToSection(ComboSectionNames[ComboCount], ComboAttackMontage);
 				}
+
+				// every combo stage is its own swing
+				NotifySwingStarted();
 			}
 		}
 	}
@@ -322,10 +551,24 @@ void ACombatCharacter::CheckChargedAttack()
 	{
 		AnimInstance->Montage_JumpToSection(bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage);
 	}
+
+	// the charged attack only swings once the charge is released
+	if (!bIsChargingAttack)
+	{
+		NotifySwingStarted();
+	}
 }
 
 void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// damage is only applied by the server. Clients go through ApplyPredictedDamage instead
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	NetworkCompulsoryHitch::RecordEvent(TEXT("ApplyDamage"), this);
+
 	// pass the damage event to the actor
 	FDamageEvent DamageEvent;
 	const float ActualDamage = TakeDamage(Damage, DamageEvent, nullptr, DamageCauser);
@@ -336,15 +579,14 @@ void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVe
 		// apply the knockback impulse
 		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
-		// is the character ragdolling?
-		if (GetMesh()->IsSimulatingPhysics())
+		// play the reaction on the server
+		PlayDamageReaction(ActualDamage, DamageLocation, DamageImpulse);
+
+		// and on any clients that didn't predict it
+		if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
 		{
-			// apply an impulse to the ragdoll
-			GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+			DamageSubsystem->AddConfirmedEvent(this, ActualDamage, DamageCauser, DamageLocation, DamageImpulse);
 		}
-
-		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
 	}
 
 }
@@ -363,8 +605,17 @@ void ACombatCharacter::HandleDeath()
 	// pull back the camera
 	GetCameraBoom()->TargetArmLength = DeathCameraDistance;
 
+	// only the server schedules respawning
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// schedule respawning
-	GetWorld()->GetTimerManager().SetTimer(RespawnTimer, this, &ACombatCharacter::RespawnCharacter, RespawnTime, false);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->SetTimer(RespawnTimer, this, &ACombatCharacter::RespawnCharacter, RespawnTime);
+	}
 }
 
 void ACombatCharacter::ApplyHealing(float Healing, AActor* Healer)
@@ -372,16 +623,92 @@ void ACombatCharacter::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatCharacter::ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// ignore if we're already predicted to be dead. Death itself always waits for the server
+	if (CurrentHP - PredictedDamage <= 0.0f)
+	{
+		return;
+	}
+
+	// accumulate the predicted damage and update the life bar
+	PredictedDamage += Damage;
+
+	UpdateLifeBar();
+
+	// play the reaction
+	PlayDamageReaction(Damage, DamageLocation, DamageImpulse);
+}
+
+void ACombatCharacter::CancelPredictedDamage()
+{
+	// restore the life bar to the server's HP
+	PredictedDamage = 0.0f;
+
+	UpdateLifeBar();
+}
+
+void ACombatCharacter::PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// apply the knockback right away on the owning client instead of waiting for a movement correction
+	if (IsLocallyControlled())
+	{
+		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
+	}
+
+	PlayDamageReaction(Damage, DamageLocation, DamageImpulse);
+}
+
 void ACombatCharacter::RespawnCharacter()
 {
-	// destroy the character and let it be respawned by the Player Controller
+	// let the Player Controller reset us in place at the respawn transform
+	if (ACombatPlayerController* PC = Cast<ACombatPlayerController>(GetController()))
+	{
+		if (PC->RespawnPawn())
+		{
+			return;
+		}
+	}
+
+	// no respawn transform available, so destroy the character and let it be re-created by the Player Controller
 	Destroy();
 }
 
+void ACombatCharacter::ResetCharacter(const FTransform& SpawnTransform)
+{
+	// only the server can bring the character back to life
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// cancel any pending respawn
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(RespawnTimer);
+	}
+
+	// undo the death state on the server
+	RestoreFromDeath();
+
+	// move the character to the respawn transform
+	GetCharacterMovement()->StopMovementImmediately();
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+
+	// face the respawn direction
+	if (Controller)
+	{
+		Controller->ClientSetRotation(SpawnTransform.Rotator(), true);
+	}
+
+	// reset HP. Clients restore themselves when they receive the new HP
+	ResetHP();
+}
+
 float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	// only process damage on the server, and only if the character is still alive
+	if (!HasAuthority() || CurrentHP <= 0.0f)
 	{
 		return 0.0f;
 	}
@@ -398,11 +725,7 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
-
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		UpdateLifeBar();
 	}
 
 	// return the received damage amount
@@ -423,10 +746,17 @@ void ACombatCharacter::Landed(const FHitResult& Hit)
 
 void ACombatCharacter::BeginPlay()
 {
+	// create the life bar widget up front so it's tracked under the UI memory tag
+	{
+		LLM_SCOPE_BYTAG(NCUI);
+		LifeBar->InitWidget();
+	}
+
 	Super::BeginPlay();
 
 	// get the life bar from the widget component
 	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
+	NetworkCompulsoryHitch::RecordEvent(TEXT("CreateLifeBar"), this);
 	check(LifeBarWidget);
 
 	// initialize the camera
@@ -438,8 +768,15 @@ void ACombatCharacter::BeginPlay()
 	// set the life bar color
 	LifeBarWidget->SetBarColor(LifeBarColor);
 
-	// reset HP to maximum
-	ResetHP();
+	// reset HP to maximum. Clients receive their HP through replication
+	if (HasAuthority())
+	{
+		ResetHP();
+
+	} else {
+
+		UpdateLifeBar();
+	}
 }
 
 void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -447,7 +784,10 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 
 	// clear the respawn timer
-	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(RespawnTimer);
+	}
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -484,3 +824,10 @@ void ACombatCharacter::NotifyControllerChanged()
 	}
 }
 
+void ACombatCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// replicate the current HP
+	DOREPLIFETIME(ACombatCharacter, CurrentHP);
+}
@@ -7,6 +7,7 @@
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
 #include "Animation/AnimInstance.h"
+#include "GameplayTimerSubsystem.h"
 #include "CombatCharacter.generated.h"
 
 class USpringArmComponent;
@@ -18,6 +19,27 @@ class UWidgetComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
 
+/**
+ *  A melee hit detected and predicted by an owning client, sent to the server for validation
+ */
+USTRUCT()
+struct FCombatHitReport
+{
+	GENERATED_BODY()
+
+	/** Actor that was hit */
+	UPROPERTY()
+	TObjectPtr<AActor> Target;
+
+	/** World location of the hit */
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	/** Knockback impulse applied by the hit */
+	UPROPERTY()
+	FVector_NetQuantize10 Impulse;
+};
+
 /**
  *  An enhanced Third Person Character with melee combat capabilities:
  *  - Combo attack string
@@ -25,6 +47,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
  *  - Damage dealing and reaction
  *  - Death
  *  - Respawning
+ *  - Server authoritative HP with client predicted hit reactions
  */
 UCLASS(abstract)
 class ACombatCharacter : public ACharacter, public ICombatAttacker, public ICombatDamageable
@@ -73,10 +96,13 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float MaxHP = 5.0f;
 
-	/** Current amount of HP the character has */
-	UPROPERTY(VisibleAnywhere, Category="Damage")
+	/** Current amount of HP the character has. Only modified by the server */
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_CurrentHP, Category="Damage")
 	float CurrentHP = 0.0f;
 
+	/** Damage predicted on this machine that hasn't been confirmed by the server yet */
+	float PredictedDamage = 0.0f;
+
 	/** Life bar widget fill color */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FLinearColor LifeBarColor;
@@ -119,6 +145,28 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
 	float MeleeLaunchImpulse = 300.0f;
 
+	/** Extra distance allowed by the server when validating hits reported by clients, to account for latency */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Network", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float HitValidationTolerance = 100.0f;
+
+	/** Max number of hits the server will accept from a single client attack trace */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Network", meta = (ClampMin = 1, ClampMax = 32))
+	int32 MaxReportedHits = 8;
+
+	/** Time after a client starts a swing during which the server accepts its hit report */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Network", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float AttackWindowDuration = 1.0f;
+
+	/** Minimum time between swings the server will open an attack window for */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Network", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float MinAttackInterval = 0.2f;
+
+	/** Server time the current attack window closes. Zero when no window is open */
+	float AttackWindowEndTime = 0.0f;
+
+	/** Server time the last attack window was opened */
+	float LastAttackWindowTime = -1.0f;
+
 	/** AnimMontage that will play for combo attacks */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
 	UAnimMontage* ComboAttackMontage;
@@ -168,7 +216,7 @@ protected:
 	FOnMontageEnded OnAttackMontageEnded;
 
 	/** Character respawn timer */
-	FTimerHandle RespawnTimer;
+	FGameplayTimerHandle RespawnTimer;
 
 	/** Copy of the mesh's transform so we can reset it after ragdoll animations */
 	FTransform MeshStartingTransform;
@@ -226,6 +274,34 @@ protected:
 	/** Resets the character's current HP to maximum */
 	void ResetHP();
 
+	/** Updates the life bar from the current and predicted HP */
+	void UpdateLifeBar();
+
+	/** Plays the ragdoll and effects reaction to a hit. Runs on every machine */
+	void PlayDamageReaction(float Damage, const FVector& DamageLocation, const FVector& DamageImpulse);
+
+	/** Handles HP replication */
+	UFUNCTION()
+	void OnRep_CurrentHP(float OldHP);
+
+	/** Undoes the death ragdoll, camera, life bar and movement state. Runs on every machine */
+	void RestoreFromDeath();
+
+	/** Tells the server the owning client started a swing, so it accepts one hit report for it */
+	void NotifySwingStarted();
+
+	/** Opens an attack window for the owning client's swing */
+	UFUNCTION(Server, Reliable)
+	void ServerStartSwing();
+
+	/** Validates and applies the hits predicted by the owning client */
+	UFUNCTION(Server, Reliable)
+	void ServerReportHits(const TArray<FCombatHitReport>& Hits);
+
+	/** Tells the owning client which of its predicted hits were rejected by the server */
+	UFUNCTION(Client, Reliable)
+	void ClientRejectHits(const TArray<AActor*>& Targets);
+
 	/** Performs a combo attack */
 	void ComboAttack();
 
@@ -262,11 +338,23 @@ public:
 	/** Handles healing events */
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
+	/** Plays damage reactions locally ahead of server confirmation */
+	virtual void ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
+	/** Rolls back any predicted damage the server didn't confirm */
+	virtual void CancelPredictedDamage() override;
+
+	/** Plays a damage reaction confirmed by the server */
+	virtual void PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
 	// ~end CombatDamageable interface
 
-	/** Called from the respawn timer to destroy and re-create the character */
+	/** Called from the respawn timer to respawn the character in place through the Player Controller */
 	void RespawnCharacter();
 
+	/** Brings the character back to life at the provided transform without re-creating it. Server only */
+	void ResetCharacter(const FTransform& SpawnTransform);
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
@@ -299,6 +387,9 @@ protected:
 	/** Handles possessed initialization */
 	virtual void NotifyControllerChanged() override;
 
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 public:
 
 	/** Returns CameraBoom subobject **/
@@ -2,8 +2,13 @@
 
 
 #include "Variant_Combat/CombatGameMode.h"
+#include "ReplaySpectatorPlayerController.h"
 
 ACombatGameMode::ACombatGameMode()
 {
+	// keep players connected when the server changes maps
+	bUseSeamlessTravel = true;
 
+	// spectate recorded matches with the scrubbing replay controller
+	ReplaySpectatorPlayerControllerClass = AReplaySpectatorPlayerController::StaticClass();
 }
\ No newline at end of file
@@ -4,13 +4,13 @@
 #include "Variant_Combat/CombatPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
+#include "PlayerSpawnSubsystem.h"
 #include "CombatCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
 #include "Blueprint/UserWidget.h"
 #include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
 void ACombatPlayerController::BeginPlay()
@@ -21,6 +21,7 @@ void ACombatPlayerController::BeginPlay()
 	if (SVirtualJoystick::ShouldDisplayTouchInterface() && IsLocalPlayerController())
 	{
 		// spawn the mobile controls widget
+		LLM_SCOPE_BYTAG(NCUI);
 		MobileControlsWidget = CreateWidget<UUserWidget>(this, MobileControlsWidgetClass);
 
 		if (MobileControlsWidget)
@@ -72,16 +73,69 @@ void ACombatPlayerController::OnPossess(APawn* InPawn)
 
 void ACombatPlayerController::SetRespawnTransform(const FTransform& NewRespawn)
 {
-	// save the new respawn transform
-	RespawnTransform = NewRespawn;
+	// save the new respawn transform as our checkpoint
+	if (UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>())
+	{
+		Spawns->SetCheckpoint(this, NewRespawn);
+	}
+}
+
+bool ACombatPlayerController::RespawnPawn()
+{
+	ACombatCharacter* CombatCharacter = Cast<ACombatCharacter>(GetPawn());
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
+
+	if (!CombatCharacter || !Spawns)
+	{
+		return false;
+	}
+
+	// find the respawn transform. This will be our checkpoint if we have one
+	FTransform SpawnTransform;
+
+	if (!Spawns->FindSpawnTransform(this, SpawnPointPolicy, CombatCharacter->GetActorLocation(), SpawnTransform))
+	{
+		return false;
+	}
+
+	// reuse the existing character instead of spawning a new one
+	CombatCharacter->ResetCharacter(SpawnTransform);
+
+	NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), CombatCharacter);
+
+	return true;
 }
 
 void ACombatPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
-	// spawn a new character at the respawn transform
-	if (ACombatCharacter* RespawnedCharacter = GetWorld()->SpawnActor<ACombatCharacter>(CharacterClass, RespawnTransform))
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
+
+	if (!Spawns)
+	{
+		return;
+	}
+
+	// find the respawn transform. This will be our checkpoint if we have one
+	FTransform SpawnTransform;
+
+	if (Spawns->FindSpawnTransform(this, SpawnPointPolicy, DestroyedActor->GetActorLocation(), SpawnTransform))
+	{
+		// get a character at the respawn transform
+		if (ACombatCharacter* RespawnedCharacter = Cast<ACombatCharacter>(Spawns->SpawnPawn(CharacterClass, SpawnTransform)))
+		{
+			// possess the character
+			Possess(RespawnedCharacter);
+
+			NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), RespawnedCharacter);
+		}
+	}
+}
+
+void ACombatPlayerController::ClientReceiveDamageEvents_Implementation(const TArray<FCombatDamageEvent>& Events)
+{
+	// pass the events to the damage subsystem
+	if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
 	{
-		// possess the character
-		Possess(RespawnedCharacter);
+		DamageSubsystem->ReceiveConfirmedEvents(Events);
 	}
-}
\ No newline at end of file
+}
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "PlayerSpawnSubsystem.h"
+#include "CombatDamageSubsystem.h"
 #include "CombatPlayerController.generated.h"
 
 class UInputMappingContext;
@@ -12,7 +14,9 @@ class ACombatCharacter;
 /**
  *  Simple Player Controller for a third person combat game
  *  Manages input mappings
- *  Respawns the player character at the checkpoint when it's destroyed
+ *  Respawns the player character in place at the checkpoint when it dies,
+ *  or re-creates it if it's destroyed
+ *  Receives the batched damage reactions relevant to this player
  */
 UCLASS(abstract)
 class ACombatPlayerController : public APlayerController
@@ -40,8 +44,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Respawn")
 	TSubclassOf<ACombatCharacter> CharacterClass;
 
-	/** Transform to respawn the character at. Can be set to create checkpoints */
-	FTransform RespawnTransform;
+	/** Policy used to choose the spawn point when respawning without a checkpoint */
+	UPROPERTY(EditAnywhere, Category="Respawn")
+	ESpawnPointPolicy SpawnPointPolicy = ESpawnPointPolicy::First;
 
 protected:
 
@@ -56,9 +61,16 @@ protected:
 
 public:
 
-	/** Updates the character respawn transform */
+	/** Updates the character respawn transform. Stored as a checkpoint in the player spawn subsystem */
 	void SetRespawnTransform(const FTransform& NewRespawn);
 
+	/** Resets the possessed character in place at the respawn transform. Returns false if the character couldn't be respawned */
+	bool RespawnPawn();
+
+	/** Replicates a frame's worth of confirmed damage reactions for targets relevant to this player */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveDamageEvents(const TArray<FCombatDamageEvent>& Events);
+
 protected:
 
 	/** Called if the possessed pawn is destroyed */
@@ -5,6 +5,9 @@
 #include "Components/BoxComponent.h"
 #include "GameFramework/Character.h"
 #include "CombatActivatable.h"
+#include "CombatTriggerSubsystem.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
 
 ACombatActivationVolume::ACombatActivationVolume()
 {
@@ -17,17 +20,37 @@ ACombatActivationVolume::ACombatActivationVolume()
 	// set the box's extent
 	Box->SetBoxExtent(FVector(500.0f, 500.0f, 500.0f));
 
-	// set the default collision profile to overlap all dynamic
-	Box->SetCollisionProfileName(FName("OverlapAllDynamic"));
+	// the trigger subsystem tests player pawns against the box, so it doesn't need any collision
+	Box->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	Box->SetGenerateOverlapEvents(false);
+}
+
+void ACombatActivationVolume::BeginPlay()
+{
+	Super::BeginPlay();
 
-	// bind the begin overlap 
-	Box->OnComponentBeginOverlap.AddDynamic(this, &ACombatActivationVolume::OnOverlap);
+	// register with the trigger subsystem
+	if (UCombatTriggerSubsystem* Triggers = GetWorld()->GetSubsystem<UCombatTriggerSubsystem>())
+	{
+		TriggerId = Triggers->RegisterTrigger(this, Box, FOnCombatTriggerEntered::CreateUObject(this, &ACombatActivationVolume::OnPlayerEntered));
+	}
+}
+
+void ACombatActivationVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// unregister from the trigger subsystem
+	if (UCombatTriggerSubsystem* Triggers = GetWorld()->GetSubsystem<UCombatTriggerSubsystem>())
+	{
+		Triggers->UnregisterTrigger(TriggerId);
+	}
 }
 
-void ACombatActivationVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void ACombatActivationVolume::OnPlayerEntered(APawn* PlayerPawn)
 {
 	// has a Character entered the volume?
-	ACharacter* PlayerCharacter = Cast<ACharacter>(OtherActor);
+	ACharacter* PlayerCharacter = Cast<ACharacter>(PlayerPawn);
 
 	if (PlayerCharacter)
 	{
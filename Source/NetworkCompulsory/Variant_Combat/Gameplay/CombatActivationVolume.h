@@ -10,6 +10,7 @@ class UBoxComponent;
 
 /**
  *  A simple volume that activates a list of actors when the player pawn enters.
+ *  Player pawns are tested by the trigger subsystem, so the box doesn't generate overlaps
  */
 UCLASS()
 class ACombatActivationVolume : public AActor
@@ -26,6 +27,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Activation Volume")
 	TArray<AActor*> ActorsToActivate;
 
+	/** Id of this volume in the trigger subsystem */
+	int32 TriggerId = INDEX_NONE;
+
 public:	
 	
 	/** Constructor */
@@ -33,8 +37,13 @@ public:
 
 protected:
 
-	/** Handles overlaps with the box volume */
-	UFUNCTION()
-	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	/** Registers the volume with the trigger subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the volume from the trigger subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Handles a player pawn entering the box volume */
+	void OnPlayerEntered(APawn* PlayerPawn);
 
 };
@@ -4,6 +4,9 @@
 #include "CombatCheckpointVolume.h"
 #include "CombatCharacter.h"
 #include "CombatPlayerController.h"
+#include "CombatTriggerSubsystem.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
 
 ACombatCheckpointVolume::ACombatCheckpointVolume()
 {
@@ -14,14 +17,34 @@ ACombatCheckpointVolume::ACombatCheckpointVolume()
 	// set the box's extent
 	Box->SetBoxExtent(FVector(500.0f, 500.0f, 500.0f));
 
-	// set the default collision profile to overlap all dynamic
-	Box->SetCollisionProfileName(FName("OverlapAllDynamic"));
+	// the trigger subsystem tests player pawns against the box, so it doesn't need any collision
+	Box->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	Box->SetGenerateOverlapEvents(false);
+}
+
+void ACombatCheckpointVolume::BeginPlay()
+{
+	Super::BeginPlay();
 
-	// bind the begin overlap 
-	Box->OnComponentBeginOverlap.AddDynamic(this, &ACombatCheckpointVolume::OnOverlap);
+	// register with the trigger subsystem
+	if (UCombatTriggerSubsystem* Triggers = GetWorld()->GetSubsystem<UCombatTriggerSubsystem>())
+	{
+		TriggerId = Triggers->RegisterTrigger(this, Box, FOnCombatTriggerEntered::CreateUObject(this, &ACombatCheckpointVolume::OnPlayerEntered));
+	}
+}
+
+void ACombatCheckpointVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// unregister from the trigger subsystem
+	if (UCombatTriggerSubsystem* Triggers = GetWorld()->GetSubsystem<UCombatTriggerSubsystem>())
+	{
+		Triggers->UnregisterTrigger(TriggerId);
+	}
 }
 
-void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void ACombatCheckpointVolume::OnPlayerEntered(APawn* PlayerPawn)
 {
 	// ensure we use this only once
 	if (bCheckpointUsed)
@@ -30,7 +53,7 @@ void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 	}
 		
 	// has the player entered this volume?
-	ACombatCharacter* PlayerCharacter = Cast<ACombatCharacter>(OtherActor);
+	ACombatCharacter* PlayerCharacter = Cast<ACombatCharacter>(PlayerPawn);
 
 	if (PlayerCharacter)
 	{
@@ -26,7 +26,15 @@ protected:
 	/** Set to true after use to avoid accidentally resetting the checkpoint */
 	bool bCheckpointUsed = false;
 
-	/** Handles overlaps with the box volume */
-	UFUNCTION()
-	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	/** Id of this volume in the trigger subsystem */
+	int32 TriggerId = INDEX_NONE;
+
+	/** Registers the volume with the trigger subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the volume from the trigger subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Handles a player pawn entering the box volume */
+	void OnPlayerEntered(APawn* PlayerPawn);
 };
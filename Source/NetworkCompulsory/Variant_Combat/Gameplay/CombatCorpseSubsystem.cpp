@@ -0,0 +1,157 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatCorpseSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/MovementComponent.h"
+#include "Engine/World.h"
+#include "NetworkCompulsory.h"
+
+void UCombatCorpseSubsystem::RegisterCorpse(AActor* Corpse, UPrimitiveComponent* Body, float Lifetime)
+{
+	// ensure the corpse is valid
+	if (!IsValid(Corpse))
+	{
+		return;
+	}
+
+	// add the corpse at the end of the list so the list stays in age order
+	FCombatCorpseEntry& Entry = Corpses.AddDefaulted_GetRef();
+	Entry.Actor = Corpse;
+	Entry.Body = Body;
+	Entry.RegisterTime = GetWorld()->GetTimeSeconds();
+	Entry.ExpireTime = Entry.RegisterTime + Lifetime;
+
+	// are we over budget? remove the oldest corpses first
+	while (Corpses.Num() > MaxCorpses)
+	{
+		RemoveCorpse(Corpses[0]);
+		Corpses.RemoveAt(0, EAllowShrinking::No);
+	}
+}
+
+void UCombatCorpseSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const float SettleSpeedSquared = SettleSpeed * SettleSpeed;
+
+	// iterate backwards so we can remove entries in place without breaking age order
+	for (int32 i = Corpses.Num() - 1; i >= 0; --i)
+	{
+		FCombatCorpseEntry& Entry = Corpses[i];
+
+		// drop entries for actors that were destroyed by someone else
+		if (!Entry.Actor.IsValid())
+		{
+			Corpses.RemoveAt(i, EAllowShrinking::No);
+			continue;
+		}
+
+		// has the corpse expired?
+		if (CurrentTime >= Entry.ExpireTime)
+		{
+			RemoveCorpse(Entry);
+			Corpses.RemoveAt(i, EAllowShrinking::No);
+			continue;
+		}
+
+		// only simulating bodies need a settle check
+		if (Entry.State != ECombatCorpseState::Simulating)
+		{
+			continue;
+		}
+
+		UPrimitiveComponent* Body = Entry.Body.Get();
+
+		// nothing to freeze if the body isn't simulating anymore
+		if (!Body || !Body->IsSimulatingPhysics())
+		{
+			Entry.State = ECombatCorpseState::Frozen;
+			continue;
+		}
+
+		// give the body some time to fall before checking if it's settled
+		if (CurrentTime - Entry.RegisterTime < MinSimulationTime)
+		{
+			continue;
+		}
+
+		// is the body asleep or moving slowly enough to be considered at rest?
+		if (!Body->RigidBodyIsAwake() || Body->GetPhysicsLinearVelocity().SizeSquared() <= SettleSpeedSquared)
+		{
+			Entry.SettledTime += DeltaTime;
+
+			if (Entry.SettledTime >= SettleTime)
+			{
+				FreezeCorpse(Entry);
+			}
+
+		} else {
+
+			// the body moved again, restart the settle check
+			Entry.SettledTime = 0.0f;
+		}
+	}
+}
+
+TStatId UCombatCorpseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatCorpseSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+void UCombatCorpseSubsystem::Deinitialize()
+{
+	// the world is going away, so we don't need to destroy anything
+	Corpses.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatCorpseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatCorpseSubsystem::FreezeCorpse(FCombatCorpseEntry& Entry)
+{
+	Entry.State = ECombatCorpseState::Frozen;
+
+	AActor* Corpse = Entry.Actor.Get();
+	UPrimitiveComponent* Body = Entry.Body.Get();
+
+	// skeletal meshes keep their last ragdoll pose as long as we stop updating the skeleton
+	if (USkeletalMeshComponent* SkeletalBody = Cast<USkeletalMeshComponent>(Body))
+	{
+		SkeletalBody->bPauseAnims = true;
+		SkeletalBody->bNoSkeletonUpdate = true;
+	}
+
+	// stop ticking the body and any movement components
+	Body->SetComponentTickEnabled(false);
+
+	if (UMovementComponent* Movement = Corpse->FindComponentByClass<UMovementComponent>())
+	{
+		Movement->SetComponentTickEnabled(false);
+	}
+
+	Corpse->SetActorTickEnabled(false);
+
+	// take the body out of the physics scene entirely
+	Body->PutAllRigidBodiesToSleep();
+	Body->SetSimulatePhysics(false);
+	Body->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+void UCombatCorpseSubsystem::RemoveCorpse(FCombatCorpseEntry& Entry)
+{
+	// destroy the actor. Replicated corpses are destroyed by the server and removed from clients through replication
+	AActor* Corpse = Entry.Actor.Get();
+
+	if (Corpse && (Corpse->HasAuthority() || !Corpse->GetIsReplicated()))
+	{
+		Corpse->Destroy();
+	}
+}
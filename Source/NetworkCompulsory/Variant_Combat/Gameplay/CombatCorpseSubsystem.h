@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCorpseSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ *  Lifecycle state of a tracked corpse
+ */
+enum class ECombatCorpseState : uint8
+{
+	/** Physics is still simulating, waiting for the body to settle */
+	Simulating,
+
+	/** Physics has been turned off and the last pose is kept as a static representation */
+	Frozen
+};
+
+/**
+ *  Bookkeeping for a single dying actor
+ */
+struct FCombatCorpseEntry
+{
+	/** Dying actor */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Physics simulating component that drives the corpse */
+	TWeakObjectPtr<UPrimitiveComponent> Body;
+
+	/** World time at which the corpse was registered */
+	float RegisterTime = 0.0f;
+
+	/** World time at which the corpse should be removed from the level */
+	float ExpireTime = 0.0f;
+
+	/** Accumulated time the body has spent below the settle velocity */
+	float SettledTime = 0.0f;
+
+	/** Current lifecycle state */
+	ECombatCorpseState State = ECombatCorpseState::Simulating;
+};
+
+/**
+ *  Central manager for dead enemies and destroyed props.
+ *  Replaces per-actor death timers with a single age-ordered list:
+ *  - Puts simulating bodies to sleep once they settle and freezes their last pose
+ *  - Removes corpses from the level when their lifetime expires
+ *  - Removes the oldest corpses early to stay under a max corpse budget
+ */
+UCLASS(config=Game)
+class UCombatCorpseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of corpses allowed in the level at once. Oldest corpses are removed first */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 1, ClampMax = 1000))
+	int32 MaxCorpses = 32;
+
+	/** Min time a corpse must simulate before it's allowed to freeze */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float MinSimulationTime = 1.0f;
+
+	/** Linear speed under which a body is considered to be at rest */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, ClampMax = 100, Units = "cm/s"))
+	float SettleSpeed = 5.0f;
+
+	/** Time a body needs to stay at rest before it's frozen */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float SettleTime = 0.5f;
+
+	/** Tracked corpses, in registration (age) order */
+	TArray<FCombatCorpseEntry> Corpses;
+
+public:
+
+	/** Starts tracking a dying actor. The actor will be removed from the level after the provided lifetime */
+	void RegisterCorpse(AActor* Corpse, UPrimitiveComponent* Body, float Lifetime);
+
+	/** Returns the number of corpses currently being tracked */
+	int32 GetNumCorpses() const { return Corpses.Num(); }
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Updates the corpse list */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Stops physics on a settled body and keeps its current pose */
+	void FreezeCorpse(FCombatCorpseEntry& Entry);
+
+	/** Destroys the actor owned by a corpse entry */
+	void RemoveCorpse(FCombatCorpseEntry& Entry);
+};
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDamageSubsystem.h"
+#include "CombatDamageable.h"
+#include "CombatPlayerController.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetSerialization.h"
+#include "Serialization/BitWriter.h"
+#include "NetworkCompulsory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Per Frame"), STAT_CombatDamageEvents, STATGROUP_NetworkCompulsory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Replicated Damage Events"), STAT_CombatReplicatedDamageEvents, STATGROUP_NetworkCompulsory);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Bytes Per Damage Event"), STAT_CombatBytesPerDamageEvent, STATGROUP_NetworkCompulsory);
+
+bool FCombatDamageEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// object references go through the package map
+	Ar << Target;
+	Ar << DamageCauser;
+
+	bOutSuccess = SerializePayload(Ar);
+
+	return true;
+}
+
+bool FCombatDamageEvent::SerializePayload(FArchive& Ar)
+{
+	// quantize the damage to 1/100 units
+	uint16 PackedDamage = 0;
+
+	if (Ar.IsSaving())
+	{
+		PackedDamage = uint16(FMath::Clamp(FMath::RoundToInt(Damage * 100.0f), 0, MAX_uint16));
+	}
+
+	Ar << PackedDamage;
+
+	if (Ar.IsLoading())
+	{
+		Damage = PackedDamage / 100.0f;
+	}
+
+	// pack the vectors with the same precision as FVector_NetQuantize and FVector_NetQuantize10
+	bool bSuccess = SerializePackedVector<1, 20>(Location, Ar);
+	bSuccess &= SerializePackedVector<10, 24>(Impulse, Ar);
+
+	return bSuccess;
+}
+
+void UCombatDamageSubsystem::QueueDamage(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// only the server applies damage
+	if (!IsValid(Target) || IsNetClient())
+	{
+		return;
+	}
+
+	FCombatDamageEvent& Event = PendingDamage.AddDefaulted_GetRef();
+	Event.Target = Target;
+	Event.DamageCauser = DamageCauser;
+	Event.Damage = Damage;
+	Event.Location = DamageLocation;
+	Event.Impulse = DamageImpulse;
+}
+
+void UCombatDamageSubsystem::AddConfirmedEvent(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// nobody to replicate to if we're a client or playing offline
+	if (IsNetClient() || GetWorld()->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	FCombatDamageEvent& Event = ConfirmedEvents.AddDefaulted_GetRef();
+	Event.Target = Target;
+	Event.DamageCauser = DamageCauser;
+	Event.Damage = Damage;
+	Event.Location = DamageLocation;
+	Event.Impulse = DamageImpulse;
+}
+
+void UCombatDamageSubsystem::ReceiveConfirmedEvents(const TArray<FCombatDamageEvent>& Events)
+{
+	for (const FCombatDamageEvent& Event : Events)
+	{
+		// targets that aren't relevant to this client resolve to null
+		ICombatDamageable* Damageable = Cast<ICombatDamageable>(Event.Target);
+
+		if (!Damageable)
+		{
+			continue;
+		}
+
+		// skip reactions the local player already predicted
+		if (ICombatDamageable::WasPredictedLocally(Event.DamageCauser))
+		{
+			continue;
+		}
+
+		Damageable->PlayConfirmedDamage(Event.Damage, Event.DamageCauser, Event.Location, Event.Impulse);
+	}
+}
+
+void UCombatDamageSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingDamage.Num() > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_CombatDamageEvents, PendingDamage.Num());
+
+		// take the batch out of the queue. Any damage dealt while applying it will be processed next frame
+		TArray<FCombatDamageEvent> Batch = MoveTemp(PendingDamage);
+		PendingDamage.Reset();
+
+		// apply all damage in a single pass
+		for (const FCombatDamageEvent& Event : Batch)
+		{
+			// skip targets that were destroyed since the damage was queued
+			if (!IsValid(Event.Target))
+			{
+				continue;
+			}
+
+			if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Event.Target))
+			{
+				Damageable->ApplyDamage(Event.Damage, Event.DamageCauser, Event.Location, Event.Impulse);
+			}
+		}
+	}
+
+	// replicate everything that was confirmed this frame
+	FlushConfirmedEvents();
+}
+
+TStatId UCombatDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+void UCombatDamageSubsystem::Deinitialize()
+{
+	// drop any unprocessed events
+	PendingDamage.Empty();
+	ConfirmedEvents.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UCombatDamageSubsystem::IsNetClient() const
+{
+	return GetWorld()->GetNetMode() == NM_Client;
+}
+
+void UCombatDamageSubsystem::FlushConfirmedEvents()
+{
+	if (ConfirmedEvents.Num() == 0)
+	{
+		return;
+	}
+
+#if STATS
+	// measure the packed payload. Object references are estimated at one 32 bit net GUID each
+	FBitWriter PayloadWriter(0, true);
+
+	for (FCombatDamageEvent& Event : ConfirmedEvents)
+	{
+		Event.SerializePayload(PayloadWriter);
+	}
+
+	const float PayloadBytes = (PayloadWriter.GetNumBits() + 7) / 8 + ConfirmedEvents.Num() * 2 * sizeof(uint32);
+
+	SET_FLOAT_STAT(STAT_CombatBytesPerDamageEvent, PayloadBytes / ConfirmedEvents.Num());
+#endif
+
+	TArray<FCombatDamageEvent> ConnectionEvents;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		ACombatPlayerController* PlayerController = Cast<ACombatPlayerController>(It->Get());
+		UNetConnection* Connection = PlayerController ? PlayerController->GetNetConnection() : nullptr;
+
+		// the listen server's own player already played these reactions
+		if (!Connection || PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		// only send the reactions for targets this client can see
+		ConnectionEvents.Reset();
+
+		for (const FCombatDamageEvent& Event : ConfirmedEvents)
+		{
+			if (IsValid(Event.Target) && Connection->FindActorChannelRef(Event.Target.Get()))
+			{
+				ConnectionEvents.Add(Event);
+			}
+		}
+
+		if (ConnectionEvents.Num() > 0)
+		{
+			INC_DWORD_STAT_BY(STAT_CombatReplicatedDamageEvents, ConnectionEvents.Num());
+
+			PlayerController->ClientReceiveDamageEvents(ConnectionEvents);
+		}
+	}
+
+	ConfirmedEvents.Reset();
+}
@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDamageSubsystem.generated.h"
+
+/**
+ *  A single damage event, packed for replication.
+ *  Damage is quantized to 1/100 units, location to whole cm and impulse to 1/10 cm/s
+ */
+USTRUCT()
+struct FCombatDamageEvent
+{
+	GENERATED_BODY()
+
+	/** Actor receiving the damage */
+	UPROPERTY()
+	TObjectPtr<AActor> Target;
+
+	/** Actor that caused the damage */
+	UPROPERTY()
+	TObjectPtr<AActor> DamageCauser;
+
+	/** Amount of damage */
+	UPROPERTY()
+	float Damage = 0.0f;
+
+	/** World location of the hit */
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	/** Knockback impulse applied by the hit */
+	UPROPERTY()
+	FVector Impulse = FVector::ZeroVector;
+
+	/** Custom net serialization */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Serializes the quantized non-object fields. Returns false if a vector was out of range */
+	bool SerializePayload(FArchive& Ar);
+};
+
+template<>
+struct TStructOpsTypeTraits<FCombatDamageEvent> : public TStructOpsTypeTraitsBase2<FCombatDamageEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ *  Per-frame damage event buffer for the combat variant.
+ *  - Damage dealt during the frame is queued and applied to all targets in a single pass
+ *  - Confirmed damage reactions are packed and sent as one batch per client per frame,
+ *    holding only the reactions for targets that are relevant to that client
+ *  - Clients skip the reactions their local player already predicted
+ */
+UCLASS()
+class NETWORKCOMPULSORY_API UCombatDamageSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Damage queued this frame, waiting to be applied. Can be held across a garbage collection */
+	UPROPERTY()
+	TArray<FCombatDamageEvent> PendingDamage;
+
+	/** Damage reactions confirmed this frame, waiting to be replicated */
+	UPROPERTY()
+	TArray<FCombatDamageEvent> ConfirmedEvents;
+
+public:
+
+	/** Queues damage to be applied to the target at the end of the frame. Ignored on clients */
+	void QueueDamage(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse);
+
+	/** Records a damage reaction applied by the server so it can be replicated to clients. Ignored on clients */
+	void AddConfirmedEvent(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse);
+
+	/** Plays a batch of confirmed damage reactions received from the server */
+	void ReceiveConfirmedEvents(const TArray<FCombatDamageEvent>& Events);
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Applies queued damage and replicates confirmed reactions */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns true if this world is a network client and shouldn't process damage */
+	bool IsNetClient() const;
+
+	/** Sends each client the confirmed reactions for the targets it has a channel open to */
+	void FlushConfirmedEvents();
+};
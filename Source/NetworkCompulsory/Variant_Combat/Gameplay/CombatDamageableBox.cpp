@@ -3,13 +3,19 @@
 
 #include "CombatDamageableBox.h"
 #include "Components/StaticMeshComponent.h"
-#include "TimerManager.h"
+#include "CombatCorpseSubsystem.h"
+#include "CombatDamageSubsystem.h"
 #include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
 
 ACombatDamageableBox::ACombatDamageableBox()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// replicate HP and physics movement from the server
+	bReplicates = true;
+	SetReplicatingMovement(true);
+
 	// create the mesh
 	RootComponent = Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 
@@ -23,22 +29,14 @@ ACombatDamageableBox::ACombatDamageableBox()
 	Mesh->bNavigationRelevant = false;
 }
 
-void ACombatDamageableBox::RemoveFromLevel()
-{
-	// destroy this actor
-	Destroy();
-}
-
-void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
-{
-	Super::EndPlay(EndPlayReason);
-
-	// clear the death timer
-	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
-}
-
 void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
+	// damage is only applied by the server. Clients go through ApplyPredictedDamage instead
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// only process damage if we still have HP
 	if (CurrentHP > 0.0f)
 	{
@@ -56,6 +54,21 @@ void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const
 
 		// call the BP handler to play effects, etc.
 		OnBoxDamaged(DamageLocation, DamageImpulse);
+
+		// play the effects on any clients that didn't predict them
+		if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
+		{
+			DamageSubsystem->AddConfirmedEvent(this, Damage, DamageCauser, DamageLocation, DamageImpulse);
+		}
+	}
+}
+
+void ACombatDamageableBox::OnRep_CurrentHP()
+{
+	// has the server destroyed the box?
+	if (CurrentHP <= 0.0f)
+	{
+		HandleDeath();
 	}
 }
 
@@ -67,8 +80,11 @@ void ACombatDamageableBox::HandleDeath()
 	// call the BP handler to play effects, etc.
 	OnBoxDestroyed();
 
-	// set up the death cleanup timer
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatDamageableBox::RemoveFromLevel, DeathDelayTime);
+	// hand the box over to the corpse manager so it can be put to sleep and removed later
+	if (UCombatCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UCombatCorpseSubsystem>())
+	{
+		Corpses->RegisterCorpse(this, Mesh, DeathDelayTime);
+	}
 }
 
 void ACombatDamageableBox::ApplyHealing(float Healing, AActor* Healer)
@@ -76,3 +92,35 @@ void ACombatDamageableBox::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatDamageableBox::ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// ignore boxes that have already been destroyed
+	if (CurrentHP > 0.0f)
+	{
+		// push the box right away. Replicated movement will correct it if the server disagrees
+		Mesh->AddImpulseAtLocation(DamageImpulse * Mesh->GetMass(), DamageLocation);
+
+		// call the BP handler to play effects, etc.
+		OnBoxDamaged(DamageLocation, DamageImpulse);
+	}
+}
+
+void ACombatDamageableBox::CancelPredictedDamage()
+{
+	// nothing to roll back, box HP is never predicted
+}
+
+void ACombatDamageableBox::PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// call the BP handler to play effects, etc.
+	OnBoxDamaged(DamageLocation, DamageImpulse);
+}
+
+void ACombatDamageableBox::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// replicate the current HP
+	DOREPLIFETIME(ACombatDamageableBox, CurrentHP);
+}
+
@@ -9,6 +9,7 @@
 
 /**
  *  A simple physics box that reacts to damage through the ICombatDamageable interface
+ *  HP is owned by the server and replicated to clients
  */
 UCLASS(abstract)
 class ACombatDamageableBox : public AActor, public ICombatDamageable
@@ -26,17 +27,14 @@ public:
 
 protected:
 
-	/** Amount of HP this box starts with. */
-	UPROPERTY(EditAnywhere, Category="Damage")
+	/** Amount of HP this box starts with. Only modified by the server */
+	UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_CurrentHP, Category="Damage")
 	float CurrentHP = 3.0f;
 
 	/** Time to wait before we remove this box from the level. */
 	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float DeathDelayTime = 6.0f;
 
-	/** Timer to defer destruction of this box after its HP are depleted */
-	FTimerHandle DeathTimer;
-
 	/** Blueprint damage handler for effect playback */
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
 	void OnBoxDamaged(const FVector& DamageLocation, const FVector& DamageImpulse);
@@ -45,14 +43,12 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
 	void OnBoxDestroyed();
 
-	/** Timer callback to remove the box from the level after it dies */
-	void RemoveFromLevel();
+	/** Handles HP replication */
+	UFUNCTION()
+	void OnRep_CurrentHP();
 
 public:
 
-	/** EndPlay cleanup */
-	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
-
 	// ~Begin CombatDamageable interface
 
 	/** Handles damage and knockback events */
@@ -64,5 +60,19 @@ public:
 	/** Handles healing events */
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
+	/** Plays damage reactions locally ahead of server confirmation */
+	virtual void ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
+	/** Rolls back any predicted damage the server didn't confirm */
+	virtual void CancelPredictedDamage() override;
+
+	/** Plays a damage reaction confirmed by the server */
+	virtual void PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
 	// ~End CombatDamageable interface
+
+protected:
+
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 };
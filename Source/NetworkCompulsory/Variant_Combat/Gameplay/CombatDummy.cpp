@@ -5,6 +5,8 @@
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "CombatDamageSubsystem.h"
+#include "Engine/World.h"
 
 ACombatDummy::ACombatDummy()
 {
@@ -38,6 +40,12 @@ void ACombatDummy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 
 	// call the BP handler
 	BP_OnDummyDamaged(DamageLocation, DamageImpulse.GetSafeNormal());
+
+	// replicate the reaction to clients that didn't predict it
+	if (UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>())
+	{
+		DamageSubsystem->AddConfirmedEvent(this, Damage, DamageCauser, DamageLocation, DamageImpulse);
+	}
 }
 
 void ACombatDummy::HandleDeath()
@@ -48,4 +56,24 @@ void ACombatDummy::HandleDeath()
 void ACombatDummy::ApplyHealing(float Healing, AActor* Healer)
 {
 	// unused
+}
+
+void ACombatDummy::ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// the dummy has no state to protect, so the predicted reaction is the full reaction
+	ApplyDamage(Damage, DamageCauser, DamageLocation, DamageImpulse);
+}
+
+void ACombatDummy::CancelPredictedDamage()
+{
+	// unused
+}
+
+void ACombatDummy::PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
+{
+	// apply impulse to the dummy
+	Dummy->AddImpulseAtLocation(DamageImpulse, DamageLocation);
+
+	// call the BP handler
+	BP_OnDummyDamaged(DamageLocation, DamageImpulse.GetSafeNormal());
 }
\ No newline at end of file
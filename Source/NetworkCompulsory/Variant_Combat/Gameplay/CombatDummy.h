@@ -50,6 +50,15 @@ public:
 	/** Handles healing events */
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
+	/** Plays damage reactions locally ahead of server confirmation */
+	virtual void ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
+	/** Rolls back any predicted damage the server didn't confirm */
+	virtual void CancelPredictedDamage() override;
+
+	/** Plays a damage reaction confirmed by the server */
+	virtual void PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) override;
+
 	// ~End CombatDamageable interface
 
 protected:
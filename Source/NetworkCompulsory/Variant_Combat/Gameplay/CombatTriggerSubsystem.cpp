@@ -0,0 +1,240 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatTriggerSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Algo/Sort.h"
+#include "NetworkCompulsory.h"
+
+int32 UCombatTriggerSubsystem::RegisterTrigger(AActor* Owner, const UBoxComponent* Box, FOnCombatTriggerEntered OnEntered)
+{
+	check(Box);
+
+	FCombatTriggerEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Id = NextTriggerId++;
+	Entry.Owner = Owner;
+	Entry.Bounds = Box->Bounds.GetBox();
+	Entry.Transform = FTransform(Box->GetComponentQuat(), Box->GetComponentLocation());
+	Entry.Extent = Box->GetScaledBoxExtent();
+	Entry.OnEntered = MoveTemp(OnEntered);
+
+	// rebuild the tree before the next query
+	bTreeDirty = true;
+
+	return Entry.Id;
+}
+
+void UCombatTriggerSubsystem::UnregisterTrigger(int32 TriggerId)
+{
+	// remove the entry and anything occupying it
+	Entries.RemoveAll([TriggerId](const FCombatTriggerEntry& Entry) { return Entry.Id == TriggerId; });
+	Occupants.RemoveAll([TriggerId](const FOccupant& Occupant) { return Occupant.TriggerId == TriggerId; });
+
+	bTreeDirty = true;
+}
+
+void UCombatTriggerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bTreeDirty)
+	{
+		RebuildTree();
+	}
+
+	if (Nodes.Num() == 0)
+	{
+		Occupants.Reset();
+		return;
+	}
+
+	TArray<FOccupant> NewOccupants;
+	TArray<FOccupant> Entered;
+	TArray<int32> Overlaps;
+
+	// test every player pawn we know about against the tree
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		Overlaps.Reset();
+		QueryPawn(Pawn, Overlaps);
+
+		for (int32 EntryIndex : Overlaps)
+		{
+			FOccupant Occupant;
+			Occupant.TriggerId = Entries[EntryIndex].Id;
+			Occupant.Pawn = Pawn;
+
+			NewOccupants.Add(Occupant);
+
+			// was the pawn outside of the trigger last frame?
+			if (!Occupants.Contains(Occupant))
+			{
+				Entered.Add(Occupant);
+			}
+		}
+	}
+
+	Occupants = MoveTemp(NewOccupants);
+
+	// fire the enter callbacks after the query, since they may add or remove triggers
+	for (const FOccupant& Occupant : Entered)
+	{
+		const FCombatTriggerEntry* Entry = Entries.FindByPredicate([&Occupant](const FCombatTriggerEntry& Candidate) { return Candidate.Id == Occupant.TriggerId; });
+
+		if (Entry && Occupant.Pawn.IsValid())
+		{
+			// copy the callback so it stays alive even if it unregisters its own trigger
+			const FOnCombatTriggerEntered OnEntered = Entry->OnEntered;
+			OnEntered.ExecuteIfBound(Occupant.Pawn.Get());
+		}
+	}
+}
+
+TStatId UCombatTriggerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatTriggerSubsystem, STATGROUP_NetworkCompulsory);
+}
+
+void UCombatTriggerSubsystem::Deinitialize()
+{
+	Entries.Empty();
+	Nodes.Empty();
+	EntryOrder.Empty();
+	Occupants.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatTriggerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatTriggerSubsystem::RebuildTree()
+{
+	bTreeDirty = false;
+
+	Nodes.Reset();
+	EntryOrder.Reset();
+
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	// start with the entries in registration order
+	EntryOrder.Reserve(Entries.Num());
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		EntryOrder.Add(i);
+	}
+
+	// a binary tree with N leaves has 2N - 1 nodes
+	Nodes.Reserve(Entries.Num() * 2);
+
+	BuildNode(0, EntryOrder.Num());
+}
+
+int32 UCombatTriggerSubsystem::BuildNode(int32 First, int32 Count)
+{
+	const int32 NodeIndex = Nodes.AddDefaulted();
+
+	// compute the bounds of this range
+	FBox Bounds(ForceInit);
+
+	for (int32 i = First; i < First + Count; ++i)
+	{
+		Bounds += Entries[EntryOrder[i]].Bounds;
+	}
+
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	// small enough for a leaf?
+	if (Count <= MaxLeafSize)
+	{
+		Nodes[NodeIndex].FirstEntry = First;
+		Nodes[NodeIndex].NumEntries = Count;
+
+		return NodeIndex;
+	}
+
+	// split along the longest axis at the median trigger center
+	const FVector Size = Bounds.GetSize();
+	const int32 Axis = (Size.X >= Size.Y && Size.X >= Size.Z) ? 0 : (Size.Y >= Size.Z ? 1 : 2);
+
+	Algo::Sort(MakeArrayView(EntryOrder.GetData() + First, Count), [this, Axis](int32 A, int32 B)
+	{
+		return Entries[A].Bounds.GetCenter()[Axis] < Entries[B].Bounds.GetCenter()[Axis];
+	});
+
+	const int32 LeftCount = Count / 2;
+
+	// build the children. Don't hold references into the node array, it may reallocate
+	const int32 Left = BuildNode(First, LeftCount);
+	const int32 Right = BuildNode(First + LeftCount, Count - LeftCount);
+
+	Nodes[NodeIndex].Left = Left;
+	Nodes[NodeIndex].Right = Right;
+
+	return NodeIndex;
+}
+
+void UCombatTriggerSubsystem::QueryPawn(const APawn* Pawn, TArray<int32>& OutEntries) const
+{
+	// approximate the pawn with its collision cylinder
+	float Radius = 0.0f;
+	float HalfHeight = 0.0f;
+	Pawn->GetSimpleCollisionCylinder(Radius, HalfHeight);
+
+	const FVector PawnLocation = Pawn->GetActorLocation();
+	const FVector PawnExtent(Radius, Radius, HalfHeight);
+	const FBox PawnBounds = FBox::BuildAABB(PawnLocation, PawnExtent);
+
+	// walk the tree
+	TArray<int32, TInlineAllocator<32>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FCombatTriggerNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+
+		// broadphase reject
+		if (!Node.Bounds.Intersect(PawnBounds))
+		{
+			continue;
+		}
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Add(Node.Left);
+			Stack.Add(Node.Right);
+			continue;
+		}
+
+		// narrowphase against the oriented trigger boxes
+		for (int32 i = Node.FirstEntry; i < Node.FirstEntry + Node.NumEntries; ++i)
+		{
+			const FCombatTriggerEntry& Entry = Entries[EntryOrder[i]];
+
+			const FVector LocalPawn = Entry.Transform.InverseTransformPosition(PawnLocation).GetAbs();
+			const FVector LocalLimit = Entry.Extent + PawnExtent;
+
+			if (LocalPawn.X <= LocalLimit.X && LocalPawn.Y <= LocalLimit.Y && LocalPawn.Z <= LocalLimit.Z)
+			{
+				OutEntries.Add(EntryOrder[i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatTriggerSubsystem.generated.h"
+
+class UBoxComponent;
+
+/** Called when a player pawn enters a trigger volume */
+DECLARE_DELEGATE_OneParam(FOnCombatTriggerEntered, APawn*);
+
+/**
+ *  A static trigger volume registered with the trigger subsystem
+ */
+struct FCombatTriggerEntry
+{
+	/** Unique id of this trigger */
+	int32 Id = INDEX_NONE;
+
+	/** Actor that owns the trigger */
+	TWeakObjectPtr<AActor> Owner;
+
+	/** World space bounding box, used by the BVH */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Unscaled world transform of the trigger box */
+	FTransform Transform;
+
+	/** Scaled half extent of the trigger box */
+	FVector Extent = FVector::ZeroVector;
+
+	/** Callback to run when a player pawn enters the trigger */
+	FOnCombatTriggerEntered OnEntered;
+};
+
+/**
+ *  A node in the trigger BVH. Leaf nodes reference a range of entries
+ */
+struct FCombatTriggerNode
+{
+	/** Bounds of everything under this node */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Child node indices. Unused for leaves */
+	int32 Left = INDEX_NONE;
+	int32 Right = INDEX_NONE;
+
+	/** Range of entries in the BVH entry order. Only used by leaves */
+	int32 FirstEntry = 0;
+	int32 NumEntries = 0;
+
+	/** Returns true if this is a leaf node */
+	bool IsLeaf() const { return NumEntries > 0; }
+};
+
+/**
+ *  Tests player pawns against a static BVH of trigger volumes once per frame.
+ *  Replaces per-volume overlap events, so trigger boxes don't need any collision at all:
+ *  - Only player controlled pawns are tested
+ *  - Volumes are assumed static and the BVH is only rebuilt when volumes are added or removed
+ *  - Enter callbacks fire once per pawn until it leaves the volume
+ */
+UCLASS()
+class UCombatTriggerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of triggers stored in a BVH leaf */
+	static constexpr int32 MaxLeafSize = 2;
+
+	/** A player pawn inside a trigger */
+	struct FOccupant
+	{
+		/** Id of the occupied trigger */
+		int32 TriggerId = INDEX_NONE;
+
+		/** Pawn inside the trigger */
+		TWeakObjectPtr<APawn> Pawn;
+
+		bool operator==(const FOccupant& Other) const { return TriggerId == Other.TriggerId && Pawn == Other.Pawn; }
+	};
+
+	/** Registered triggers */
+	TArray<FCombatTriggerEntry> Entries;
+
+	/** BVH nodes. The root is the first node */
+	TArray<FCombatTriggerNode> Nodes;
+
+	/** Entry indices, sorted so each BVH leaf references a contiguous range */
+	TArray<int32> EntryOrder;
+
+	/** Pawns that were inside a trigger last frame */
+	TArray<FOccupant> Occupants;
+
+	/** Next id to hand out to a registered trigger */
+	int32 NextTriggerId = 0;
+
+	/** If true, the BVH needs to be rebuilt before the next query */
+	bool bTreeDirty = false;
+
+public:
+
+	/** Registers a trigger box. The box is assumed to stay static. Returns the trigger id */
+	int32 RegisterTrigger(AActor* Owner, const UBoxComponent* Box, FOnCombatTriggerEntered OnEntered);
+
+	/** Removes a previously registered trigger */
+	void UnregisterTrigger(int32 TriggerId);
+
+	/** Returns the number of registered triggers */
+	int32 GetNumTriggers() const { return Entries.Num(); }
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Tests player pawns against the triggers */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+	// ~end UTickableWorldSubsystem interface
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Rebuilds the BVH from the registered triggers */
+	void RebuildTree();
+
+	/** Recursively builds a BVH node for a range of the entry order. Returns the node index */
+	int32 BuildNode(int32 First, int32 Count);
+
+	/** Adds the indices of all triggers the pawn is inside of to the provided array */
+	void QueryPawn(const APawn* Pawn, TArray<int32>& OutEntries) const;
+};
@@ -2,5 +2,14 @@
 
 
 #include "CombatDamageable.h"
+#include "GameFramework/Pawn.h"
 
 // Add default functionality here for any ICombatDamageable functions that are not pure virtual.
+
+bool ICombatDamageable::WasPredictedLocally(const AActor* DamageCauser)
+{
+	// only locally controlled pawns on clients predict their hits
+	const APawn* CauserPawn = Cast<APawn>(DamageCauser);
+
+	return CauserPawn && CauserPawn->IsLocallyControlled() && !CauserPawn->HasAuthority();
+}
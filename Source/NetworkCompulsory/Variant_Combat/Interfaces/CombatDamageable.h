@@ -9,6 +9,7 @@
 /**
  *  CombatDamageable interface
  *  Provides functionality to handle damage, healing, knockback and death
+ *  Damage is only applied on the server. Clients may play predicted reactions ahead of server confirmation
  */
 UINTERFACE(MinimalAPI, NotBlueprintable)
 class UCombatDamageable : public UInterface
@@ -33,4 +34,19 @@ public:
 	/** Handles healing events */
 	UFUNCTION(BlueprintCallable, Category="Damageable")
 	virtual void ApplyHealing(float Healing, AActor* Healer) = 0;
+
+	/** Plays damage reactions locally ahead of server confirmation. Must not change any authoritative state */
+	UFUNCTION(BlueprintCallable, Category="Damageable")
+	virtual void ApplyPredictedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) = 0;
+
+	/** Rolls back any predicted damage the server didn't confirm */
+	UFUNCTION(BlueprintCallable, Category="Damageable")
+	virtual void CancelPredictedDamage() = 0;
+
+	/** Plays a damage reaction confirmed by the server on a client that didn't predict it */
+	UFUNCTION(BlueprintCallable, Category="Damageable")
+	virtual void PlayConfirmedDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse) = 0;
+
+	/** Returns true if a damage reaction caused by this actor was already predicted on this machine */
+	static bool WasPredictedLocally(const AActor* DamageCauser);
 };
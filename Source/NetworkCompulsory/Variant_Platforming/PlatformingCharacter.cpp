@@ -4,16 +4,19 @@
 #include "PlatformingCharacter.h"
 
 #include "Components/CapsuleComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "PlatformingCharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "EnhancedInputComponent.h"
-#include "TimerManager.h"
+#include "GameplayTimerSubsystem.h"
+#include "PlatformingPlayerController.h"
 #include "Engine/LocalPlayer.h"
+#include "NetworkCompulsory.h"
 
-APlatformingCharacter::APlatformingCharacter()
+APlatformingCharacter::APlatformingCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UPlatformingCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	PrimaryActorTick.bCanEverTick = true;
 
@@ -102,10 +105,14 @@ void APlatformingCharacter::Dash()
 
 void APlatformingCharacter::MultiJump()
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_MultiJump);
+
 	// ignore jumps while dashing
 	if(bIsDashing)
 		return;
 
+	UPlatformingCharacterMovementComponent* Movement = Cast<UPlatformingCharacterMovementComponent>(GetCharacterMovement());
+
 	// are we already in the air?
 	if (GetCharacterMovement()->IsFalling())
 	{
@@ -113,37 +120,16 @@ void APlatformingCharacter::MultiJump()
 		// have we already wall jumped?
 		if (!bHasWallJumped)
 		{
-			// run a sphere sweep to check if we're in front of a wall
-			FHitResult OutHit;
-
-			const FVector TraceStart = GetActorLocation();
-			const FVector TraceEnd = TraceStart + (GetActorForwardVector() * WallJumpTraceDistance);
-			const FCollisionShape TraceShape = FCollisionShape::MakeSphere(WallJumpTraceRadius);
-
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(this);
+			// check if we've run into a wall recently
+			FVector WallNormal;
 
-			if (GetWorld()->SweepSingleByChannel(OutHit, TraceStart, TraceEnd, FQuat(), ECollisionChannel::ECC_Visibility, TraceShape, QueryParams))
+			if (FindWallJumpNormal(WallNormal))
 			{
-				// rotate the character to face away from the wall, so we're correctly oriented for the next wall jump
-				FRotator WallOrientation = OutHit.ImpactNormal.ToOrientationRotator();
-				WallOrientation.Pitch = 0.0f;
-				WallOrientation.Roll = 0.0f;
-
-				SetActorRotation(WallOrientation);
-
-				// apply a launch impulse to the character to perform the actual wall jump
-				const FVector WallJumpImpulse = (OutHit.ImpactNormal * WallJumpBounceImpulse) + (FVector::UpVector * WallJumpVerticalImpulse);
-
-				LaunchCharacter(WallJumpImpulse, true, true);
-
-				// enable the jump trail
-				SetJumpTrailState(true);
-
-				// raise the wall jump flag to prevent an immediate second wall jump
-				bHasWallJumped = true;
-
-				GetWorld()->GetTimerManager().SetTimer(WallJumpTimer, this, &APlatformingCharacter::ResetWallJump, DelayBetweenWallJumps, false);
+				// let the movement component perform the wall jump so the server replays it on the same move
+				if (Movement)
+				{
+					Movement->bWantsToWallJump = true;
+				}
 			}
 			// no wall jump, try a double jump next
 			else
@@ -165,13 +151,14 @@ void APlatformingCharacter::MultiJump()
 					// only double jump once while we're in the air
 					if (!bHasDoubleJumped)
 					{
-						bHasDoubleJumped = true;
+						// flag the double jump on the saved move
+						if (Movement)
+						{
+							Movement->bWantsToDoubleJump = true;
+						}
 
 						// use the built-in CMC functionality to do the double jump
 						Jump();
-
-						// enable the jump trail
-						SetJumpTrailState(true);
 					}
 
 				}
@@ -191,6 +178,106 @@ void APlatformingCharacter::MultiJump()
 	}
 }
 
+bool APlatformingCharacter::FindWallJumpNormal(FVector& OutNormal) const
+{
+	// look up the wall contact cached by the movement component
+	const UPlatformingCharacterMovementComponent* Movement = Cast<UPlatformingCharacterMovementComponent>(GetCharacterMovement());
+
+	if (Movement && Movement->GetWallContact(OutNormal))
+	{
+		return true;
+	}
+
+	// we haven't run into a wall recently, so run a sphere sweep to check if we're in front of one
+	const FVector TraceStart = GetActorLocation();
+	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * WallJumpTraceDistance);
+	const FCollisionShape TraceShape = FCollisionShape::MakeSphere(WallJumpTraceRadius);
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this);
+
+	FHitResult OutHit;
+
+	if (!GetWorld()->SweepSingleByChannel(OutHit, TraceStart, TraceEnd, FQuat(), ECollisionChannel::ECC_Visibility, TraceShape, QueryParams))
+	{
+		return false;
+	}
+
+	OutNormal = OutHit.ImpactNormal;
+	return true;
+}
+
+bool APlatformingCharacter::PerformWallJump()
+{
+	// ignore the request if we've already wall jumped
+	if (bHasWallJumped)
+	{
+		return false;
+	}
+
+	// make sure we've touched a wall on this machine too
+	FVector WallNormal;
+
+	if (!FindWallJumpNormal(WallNormal))
+	{
+		return false;
+	}
+
+	// rotate the character to face away from the wall, so we're correctly oriented for the next wall jump
+	FRotator WallOrientation = WallNormal.ToOrientationRotator();
+	WallOrientation.Pitch = 0.0f;
+	WallOrientation.Roll = 0.0f;
+
+	SetActorRotation(WallOrientation);
+
+	// apply a launch impulse to the character to perform the actual wall jump
+	const FVector WallJumpImpulse = (WallNormal * WallJumpBounceImpulse) + (FVector::UpVector * WallJumpVerticalImpulse);
+
+	LaunchCharacter(WallJumpImpulse, true, true);
+
+	// raise the wall jump flag to prevent an immediate second wall jump
+	bHasWallJumped = true;
+
+	// replayed moves keep the reset scheduled by the original wall jump
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		if (!Timers->IsTimerActive(WallJumpTimer))
+		{
+			Timers->SetTimer(WallJumpTimer, this, &APlatformingCharacter::ResetWallJump, DelayBetweenWallJumps);
+		}
+	}
+
+	return true;
+}
+
+bool APlatformingCharacter::PerformDoubleJump()
+{
+	// the jump itself is handled by the CMC, we only track the state
+	bHasDoubleJumped = true;
+
+	return true;
+}
+
+void APlatformingCharacter::PlayJumpEffects()
+{
+	// enable the jump trail
+	SetJumpTrailState(true);
+}
+
+void APlatformingCharacter::GetAbilityState(bool& bOutHasDashed, bool& bOutHasWallJumped, bool& bOutHasDoubleJumped) const
+{
+	bOutHasDashed = bHasDashed;
+	bOutHasWallJumped = bHasWallJumped;
+	bOutHasDoubleJumped = bHasDoubleJumped;
+}
+
+void APlatformingCharacter::RestoreAbilityState(bool bInHasDashed, bool bInHasWallJumped, bool bInHasDoubleJumped)
+{
+	bHasDashed = bInHasDashed;
+	bHasWallJumped = bInHasWallJumped;
+	bHasDoubleJumped = bInHasDoubleJumped;
+}
+
 void APlatformingCharacter::ResetWallJump()
 {
 	// reset the wall jump input lock
@@ -237,6 +324,21 @@ void APlatformingCharacter::DoDash()
 	if (bHasDashed)
 		return;
 
+	// let the movement component start the dash so the server replays it on the same move
+	if (UPlatformingCharacterMovementComponent* Movement = Cast<UPlatformingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		Movement->bWantsToDash = true;
+	}
+}
+
+bool APlatformingCharacter::PerformDash()
+{
+	// ignore the request if we've already dashed and have yet to reset
+	if (bHasDashed)
+	{
+		return false;
+	}
+
 	// raise the dash flags
 	bIsDashing = true;
 	bHasDashed = true;
@@ -247,10 +349,15 @@ void APlatformingCharacter::DoDash()
 	// reset the character velocity so we don't carry momentum into the dash
 	GetCharacterMovement()->Velocity = FVector::ZeroVector;
 
+	return true;
+}
+
+void APlatformingCharacter::PlayDashEffects()
+{
 	// enable the jump trails
 	SetJumpTrailState(true);
 
-	// play the dash montage
+	// play the dash montage. It ends the dash when it's interrupted
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
 		const float MontageLength = AnimInstance->Montage_Play(DashMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
@@ -303,6 +410,47 @@ void APlatformingCharacter::EndDash()
 	}
 }
 
+void APlatformingCharacter::ResetCharacter(const FTransform& SpawnTransform)
+{
+	// only the server can move the character back
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// clear the wall jump reset timer
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(WallJumpTimer);
+	}
+
+	// cancel any dash in progress
+	if (bIsDashing)
+	{
+		StopAnimMontage(DashMontage);
+		EndDash();
+	}
+
+	// reset the advanced jump state
+	bHasWallJumped = false;
+	bHasDoubleJumped = false;
+	bHasDashed = false;
+
+	ResetJumpState();
+	SetJumpTrailState(false);
+
+	// move the character to the respawn transform and let it fall onto the floor
+	GetCharacterMovement()->StopMovementImmediately();
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Falling);
+
+	// face the respawn direction
+	if (Controller)
+	{
+		Controller->ClientSetRotation(SpawnTransform.Rotator(), true);
+	}
+}
+
 bool APlatformingCharacter::HasDoubleJumped() const
 {
 	return bHasDoubleJumped;
@@ -318,7 +466,10 @@ void APlatformingCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 
 	// clear the wall jump reset timer
-	GetWorld()->GetTimerManager().ClearTimer(WallJumpTimer);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(WallJumpTimer);
+	}
 }
 
 void APlatformingCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -367,3 +518,23 @@ void APlatformingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode
 	}
 }
 
+void APlatformingCharacter::FellOutOfWorld(const UDamageType& DmgType)
+{
+	// clients wait for the server to move the character back
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// let the Player Controller respawn us in place
+	if (APlatformingPlayerController* PC = Cast<APlatformingPlayerController>(GetController()))
+	{
+		if (PC->RespawnPawn())
+		{
+			return;
+		}
+	}
+
+	// no respawn transform available, so destroy the character and let it be re-created by the Player Controller
+	Super::FellOutOfWorld(DmgType);
+}
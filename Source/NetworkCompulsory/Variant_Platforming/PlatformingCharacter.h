@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Animation/AnimInstance.h"
+#include "GameplayTimerSubsystem.h"
 #include "PlatformingCharacter.generated.h"
 
 
@@ -21,6 +22,7 @@ class UAnimMontage;
  *  - Double Jump
  *  - Wall Jump
  *  - Dash
+ *  Advanced jumps and dashes are routed through a custom movement component so they're predicted and replayed by the server
  */
 UCLASS(abstract)
 class APlatformingCharacter : public ACharacter
@@ -60,7 +62,7 @@ protected:
 public:
 
 	/** Constructor */
-	APlatformingCharacter();
+	APlatformingCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
@@ -79,6 +81,9 @@ protected:
 	/** Resets the wall jump input lock */
 	void ResetWallJump();
 
+	/** Looks up a wall the character has recently run into, or traces for one ahead of it. Returns true if one was found */
+	bool FindWallJumpNormal(FVector& OutNormal) const;
+
 public:
 
 	/** Handles move inputs from either controls or UI interfaces */
@@ -112,9 +117,33 @@ protected:
 
 public:
 
+	/** Performs a wall jump if we've recently run into a wall. Called from the movement component on both the owning client and the server, and again when the client replays moves. Returns true if we wall jumped */
+	bool PerformWallJump();
+
+	/** Updates the double jump state. Called from the movement component on both the owning client and the server, and again when the client replays moves. Returns true if we double jumped */
+	bool PerformDoubleJump();
+
+	/** Starts the dash. Called from the movement component on both the owning client and the server, and again when the client replays moves. Returns true if we dashed */
+	bool PerformDash();
+
+	/** Plays the jump trail after a wall jump or double jump. Skipped when replaying moves */
+	void PlayJumpEffects();
+
+	/** Plays the dash montage and jump trail. Skipped when replaying moves */
+	void PlayDashEffects();
+
+	/** Passes back the ability lockout flags, so they can be saved with each move */
+	void GetAbilityState(bool& bOutHasDashed, bool& bOutHasWallJumped, bool& bOutHasDoubleJumped) const;
+
+	/** Restores the ability lockout flags saved with a move before it's replayed */
+	void RestoreAbilityState(bool bInHasDashed, bool bInHasWallJumped, bool bInHasDoubleJumped);
+
 	/** Ends the dash state */
 	void EndDash();
 
+	/** Resets the movement state and moves the character to the provided transform without re-creating it. Server only */
+	void ResetCharacter(const FTransform& SpawnTransform);
+
 public:
 
 	/** Returns true if the character has just double jumped */
@@ -139,6 +168,9 @@ public:
 	/** Handle movement mode changes to keep track of coyote time jumps */
 	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
+	/** Respawns the character in place instead of destroying it when it falls out of the world */
+	virtual void FellOutOfWorld(const class UDamageType& DmgType) override;
+
 protected:
 
 	/** movement state flag bits, packed into a uint8 for memory efficiency */
@@ -148,12 +180,12 @@ protected:
 	uint8 bIsDashing : 1;
 
 	/** timer for wall jump input reset */
-	FTimerHandle WallJumpTimer;
+	FGameplayTimerHandle WallJumpTimer;
 
 	/** Dash montage ended delegate */
 	FOnMontageEnded OnDashMontageEnded;
 
-	/** Distance to trace ahead of the character to look for walls to jump from */
+	/** Distance to trace ahead of the character to look for walls to jump from, when we haven't run into one recently */
 	UPROPERTY(EditAnywhere, Category="Wall Jump", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
 	float WallJumpTraceDistance = 50.0f;
 
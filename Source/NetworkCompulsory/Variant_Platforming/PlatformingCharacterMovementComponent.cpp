@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "PlatformingCharacterMovementComponent.h"
+#include "PlatformingCharacter.h"
+
+void UPlatformingCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToDoubleJump = (Flags & FSavedMove_Platforming::FLAG_DoubleJump) != 0;
+	bWantsToWallJump = (Flags & FSavedMove_Platforming::FLAG_WallJump) != 0;
+	bWantsToDash = (Flags & FSavedMove_Platforming::FLAG_Dash) != 0;
+}
+
+FNetworkPredictionData_Client* UPlatformingCharacterMovementComponent::GetPredictionData_Client() const
+{
+	// lazily create the prediction data the same way the base class does
+	if (!ClientPredictionData)
+	{
+		UPlatformingCharacterMovementComponent* MutableThis = const_cast<UPlatformingCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Platforming(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UPlatformingCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// ability requests are consumed by a single move
+	const bool bDoubleJump = bWantsToDoubleJump;
+	const bool bWallJump = bWantsToWallJump;
+	const bool bDash = bWantsToDash;
+
+	bWantsToDoubleJump = bWantsToWallJump = bWantsToDash = false;
+
+	APlatformingCharacter* PlatformingCharacter = Cast<APlatformingCharacter>(CharacterOwner);
+
+	if (!PlatformingCharacter)
+	{
+		return;
+	}
+
+	// montages and trails already played when the move was first predicted, so don't restart them on replays
+	const bool bPlayEffects = !CharacterOwner->bClientUpdating;
+
+	// the character applies the ability. Any launch it requests is handled later in this same move
+	if (bDash && PlatformingCharacter->PerformDash() && bPlayEffects)
+	{
+		PlatformingCharacter->PlayDashEffects();
+	}
+
+	if (bWallJump && PlatformingCharacter->PerformWallJump() && bPlayEffects)
+	{
+		PlatformingCharacter->PlayJumpEffects();
+	}
+
+	if (bDoubleJump && PlatformingCharacter->PerformDoubleJump() && bPlayEffects)
+	{
+		PlatformingCharacter->PlayJumpEffects();
+	}
+}
+
+void FSavedMove_Platforming::Clear()
+{
+	Super::Clear();
+
+	bWantsToDoubleJump = false;
+	bWantsToWallJump = false;
+	bWantsToDash = false;
+
+	bSavedHasDashed = false;
+	bSavedHasWallJumped = false;
+	bSavedHasDoubleJumped = false;
+}
+
+uint8 FSavedMove_Platforming::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bWantsToDoubleJump)
+	{
+		Result |= FLAG_DoubleJump;
+	}
+
+	if (bWantsToWallJump)
+	{
+		Result |= FLAG_WallJump;
+	}
+
+	if (bWantsToDash)
+	{
+		Result |= FLAG_Dash;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_Platforming::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Platforming* PlatformingMove = static_cast<const FSavedMove_Platforming*>(NewMove.Get());
+
+	if (bWantsToDoubleJump != PlatformingMove->bWantsToDoubleJump || bWantsToWallJump != PlatformingMove->bWantsToWallJump || bWantsToDash != PlatformingMove->bWantsToDash)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Platforming::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UPlatformingCharacterMovementComponent* Movement = Cast<UPlatformingCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		bWantsToDoubleJump = Movement->bWantsToDoubleJump;
+		bWantsToWallJump = Movement->bWantsToWallJump;
+		bWantsToDash = Movement->bWantsToDash;
+	}
+
+	// save the ability lockouts at the start of the move, so replays gate the abilities the same way
+	if (const APlatformingCharacter* PlatformingCharacter = Cast<APlatformingCharacter>(C))
+	{
+		PlatformingCharacter->GetAbilityState(bSavedHasDashed, bSavedHasWallJumped, bSavedHasDoubleJumped);
+	}
+}
+
+void FSavedMove_Platforming::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// rewind the ability lockouts before the move is replayed
+	if (APlatformingCharacter* PlatformingCharacter = Cast<APlatformingCharacter>(C))
+	{
+		PlatformingCharacter->RestoreAbilityState(bSavedHasDashed, bSavedHasWallJumped, bSavedHasDoubleJumped);
+	}
+}
+
+FNetworkPredictionData_Client_Platforming::FNetworkPredictionData_Client_Platforming(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Platforming::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Platforming());
+}
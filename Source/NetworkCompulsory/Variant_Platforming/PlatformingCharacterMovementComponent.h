@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WallContactMovementComponent.h"
+#include "PlatformingCharacterMovementComponent.generated.h"
+
+/**
+ *  Character Movement Component for the platforming character
+ *  Double jumps, wall jumps and dashes are requested through saved move flags,
+ *  so they're predicted by the owning client and replayed by the server on the same move
+ *  Wall contacts, wall slides and correction counting are shared through UWallContactMovementComponent
+ */
+UCLASS()
+class UPlatformingCharacterMovementComponent : public UWallContactMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	/** If true, the character will double jump during the next movement update */
+	bool bWantsToDoubleJump = false;
+
+	/** If true, the character will try to wall jump during the next movement update */
+	bool bWantsToWallJump = false;
+
+	/** If true, the character will dash during the next movement update */
+	bool bWantsToDash = false;
+
+public:
+
+	/** Unpacks the ability requests from the saved move flags */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	/** Returns the client prediction data that saves the ability requests on each move */
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+
+	/** Performs any requested abilities before the move is performed */
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+};
+
+/**
+ *  Saved move for the platforming character
+ *  Carries the double jump, wall jump and dash requests, and the ability lockouts they're gated on
+ */
+class FSavedMove_Platforming : public FSavedMove_Character
+{
+	using Super = FSavedMove_Character;
+
+public:
+
+	/** Compressed flags used by each ability */
+	static constexpr uint8 FLAG_DoubleJump = FLAG_Custom_0;
+	static constexpr uint8 FLAG_WallJump = FLAG_Custom_1;
+	static constexpr uint8 FLAG_Dash = FLAG_Custom_2;
+
+	/** Ability requests captured for this move */
+	bool bWantsToDoubleJump = false;
+	bool bWantsToWallJump = false;
+	bool bWantsToDash = false;
+
+	/** Ability lockouts at the start of this move, restored before it's replayed */
+	bool bSavedHasDashed = false;
+	bool bSavedHasWallJumped = false;
+	bool bSavedHasDoubleJumped = false;
+
+	/** Resets the move state */
+	virtual void Clear() override;
+
+	/** Packs the ability requests into the move flags */
+	virtual uint8 GetCompressedFlags() const override;
+
+	/** Moves with different ability requests can't be combined */
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	/** Captures the ability requests from the movement component and the ability lockouts from the character */
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+
+	/** Restores the ability lockouts before the move is replayed */
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+/**
+ *  Client prediction data for the platforming character
+ *  Allocates platforming saved moves
+ */
+class FNetworkPredictionData_Client_Platforming : public FNetworkPredictionData_Client_Character
+{
+	using Super = FNetworkPredictionData_Client_Character;
+
+public:
+
+	/** Constructor */
+	FNetworkPredictionData_Client_Platforming(const UCharacterMovementComponent& ClientMovement);
+
+	/** Allocates a platforming saved move */
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
@@ -2,8 +2,13 @@
 
 
 #include "Variant_Platforming/PlatformingGameMode.h"
+#include "ReplaySpectatorPlayerController.h"
 
 APlatformingGameMode::APlatformingGameMode()
 {
-	// stub
+	// keep players connected when the server changes maps
+	bUseSeamlessTravel = true;
+
+	// spectate recorded matches with the scrubbing replay controller
+	ReplaySpectatorPlayerControllerClass = AReplaySpectatorPlayerController::StaticClass();
 }
\ No newline at end of file
@@ -4,13 +4,13 @@
 #include "Variant_Platforming/PlatformingPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
+#include "PlayerSpawnSubsystem.h"
 #include "PlatformingCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
 #include "Blueprint/UserWidget.h"
 #include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
 void APlatformingPlayerController::BeginPlay()
@@ -21,6 +21,7 @@ void APlatformingPlayerController::BeginPlay()
 	if (SVirtualJoystick::ShouldDisplayTouchInterface() && IsLocalPlayerController())
 	{
 		// spawn the mobile controls widget
+		LLM_SCOPE_BYTAG(NCUI);
 		MobileControlsWidget = CreateWidget<UUserWidget>(this, MobileControlsWidgetClass);
 
 		if (MobileControlsWidget)
@@ -70,21 +71,53 @@ void APlatformingPlayerController::OnPossess(APawn* InPawn)
 	InPawn->OnDestroyed.AddDynamic(this, &APlatformingPlayerController::OnPawnDestroyed);
 }
 
+bool APlatformingPlayerController::RespawnPawn()
+{
+	APlatformingCharacter* PlatformingCharacter = Cast<APlatformingCharacter>(GetPawn());
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
+
+	if (!PlatformingCharacter || !Spawns)
+	{
+		return false;
+	}
+
+	// find the best spawn point
+	FTransform SpawnTransform;
+
+	if (!Spawns->FindSpawnTransform(this, SpawnPointPolicy, PlatformingCharacter->GetActorLocation(), SpawnTransform))
+	{
+		return false;
+	}
+
+	// reuse the existing character instead of spawning a new one
+	PlatformingCharacter->ResetCharacter(SpawnTransform);
+
+	NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), PlatformingCharacter);
+
+	return true;
+}
+
 void APlatformingPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
-	// find the player start
-	TArray<AActor*> ActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
 
-	if (ActorList.Num() > 0)
+	if (!Spawns)
 	{
-		// spawn a character at the player start
-		const FTransform SpawnTransform = ActorList[0]->GetActorTransform();
+		return;
+	}
 
-		if (APlatformingCharacter* RespawnedCharacter = GetWorld()->SpawnActor<APlatformingCharacter>(CharacterClass, SpawnTransform))
+	// find the best spawn point
+	FTransform SpawnTransform;
+
+	if (Spawns->FindSpawnTransform(this, SpawnPointPolicy, DestroyedActor->GetActorLocation(), SpawnTransform))
+	{
+		// get a character at the spawn point
+		if (APlatformingCharacter* RespawnedCharacter = Cast<APlatformingCharacter>(Spawns->SpawnPawn(CharacterClass, SpawnTransform)))
 		{
 			// possess the character
 			Possess(RespawnedCharacter);
+
+			NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), RespawnedCharacter);
 		}
 	}
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "PlayerSpawnSubsystem.h"
 #include "PlatformingPlayerController.generated.h"
 
 class UInputMappingContext;
@@ -12,7 +13,8 @@ class APlatformingCharacter;
 /**
  *  Simple Player Controller for a third person platforming game
  *  Manages input mappings
- *  Respawns the player character at the Player Start when it's destroyed
+ *  Respawns the player character in place when it falls out of the world,
+ *  or at the Player Start when it's destroyed
  */
 UCLASS(abstract)
 class APlatformingPlayerController : public APlayerController
@@ -40,6 +42,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Respawn")
 	TSubclassOf<APlatformingCharacter> CharacterClass;
 
+	/** Policy used to choose the spawn point when respawning */
+	UPROPERTY(EditAnywhere, Category="Respawn")
+	ESpawnPointPolicy SpawnPointPolicy = ESpawnPointPolicy::First;
+
 protected:
 
 	/** Gameplay initialization */
@@ -51,6 +57,13 @@ protected:
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+public:
+
+	/** Resets the possessed character in place at the best spawn point. Returns false if the character couldn't be respawned */
+	bool RespawnPawn();
+
+protected:
+
 	/** Called if the possessed pawn is destroyed */
 	UFUNCTION()
 	void OnPawnDestroyed(AActor* DestroyedActor);
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "SideScrollingInteractable.h"
+#include "GameplayTimerSubsystem.h"
 #include "SideScrollingNPC.generated.h"
 
 /**
@@ -38,7 +39,7 @@ public:
 	bool bDeactivated = false;
 
 	/** Timer to reactivate the NPC */
-	FTimerHandle DeactivationTimer;
+	FGameplayTimerHandle DeactivationTimer;
 
 public:
 
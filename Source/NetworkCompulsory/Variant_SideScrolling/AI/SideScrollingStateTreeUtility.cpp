@@ -6,9 +6,13 @@
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
 #include "Kismet/GameplayStatics.h"
+#include "NetworkCompulsory.h"
 
 EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_StateTreeTaskTick);
+	INC_DWORD_STAT(STAT_NC_NumStateTreeTaskTicks);
+
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
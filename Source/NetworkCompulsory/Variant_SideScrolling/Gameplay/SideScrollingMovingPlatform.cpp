@@ -3,16 +3,38 @@
 
 #include "SideScrollingMovingPlatform.h"
 #include "Components/SceneComponent.h"
+#include "Curves/CurveFloat.h"
+#include "GameFramework/GameStateBase.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
 
 ASideScrollingMovingPlatform::ASideScrollingMovingPlatform()
 {
-	PrimaryActorTick.bCanEverTick = false;
+	// only tick while moving
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// the platform location is computed on every machine, so only replicate when a move starts
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	NetDormancy = DORM_Initial;
 
 	// create the root comp
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 }
 
 void ASideScrollingMovingPlatform::Interaction(AActor* Interactor)
+{
+	// only the server starts moves. Clients pick them up through replication
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	MoveToTarget();
+}
+
+void ASideScrollingMovingPlatform::MoveToTarget()
 {
 	// ignore interactions if we're already moving
 	if (bMoving)
@@ -23,8 +45,14 @@ void ASideScrollingMovingPlatform::Interaction(AActor* Interactor)
 	// raise the movement flag
 	bMoving = true;
 
-	// pass control to BP for the actual movement
-	BP_MoveToTarget();
+	// move back to the start if we're resting at the destination
+	bReversed = bAtTarget;
+	MoveStartTime = GetServerTime();
+
+	// send the move to clients
+	FlushNetDormancy();
+
+	StartMove();
 }
 
 void ASideScrollingMovingPlatform::ResetInteraction()
@@ -38,3 +66,131 @@ void ASideScrollingMovingPlatform::ResetInteraction()
 	// reset the movement flag
 	bMoving = false;
 }
+
+void ASideScrollingMovingPlatform::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// save the starting location
+	PlatformStart = GetActorLocation();
+
+	// catch up with any move we received before BeginPlay
+	if (MoveStartTime >= 0.0f)
+	{
+		StartMove();
+	}
+}
+
+void ASideScrollingMovingPlatform::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float Elapsed = GetServerTime() - MoveStartTime;
+
+	// have we finished the move?
+	if (Elapsed >= GetMoveLength())
+	{
+		FinishMove();
+		return;
+	}
+
+	// move the platform. Riders follow through based movement
+	SetActorLocation(EvaluateLocation(Elapsed));
+}
+
+void ASideScrollingMovingPlatform::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASideScrollingMovingPlatform, MoveStartTime);
+	DOREPLIFETIME(ASideScrollingMovingPlatform, bReversed);
+}
+
+void ASideScrollingMovingPlatform::OnRep_MoveStartTime()
+{
+	// wait for BeginPlay so we have a valid starting location
+	if (HasActorBegunPlay())
+	{
+		StartMove();
+	}
+}
+
+void ASideScrollingMovingPlatform::StartMove()
+{
+	// the move may have already finished if we joined late
+	if (GetServerTime() - MoveStartTime >= GetMoveLength())
+	{
+		FinishMove();
+		return;
+	}
+
+	SetActorTickEnabled(true);
+
+	BP_OnMoveStarted();
+}
+
+void ASideScrollingMovingPlatform::FinishMove()
+{
+	// only play the finish effects if we saw the move, not when catching up with a finished one
+	const bool bWasMoving = IsActorTickEnabled();
+
+	// stop ticking and snap to the end of the move
+	SetActorTickEnabled(false);
+	SetActorLocation(EvaluateLocation(GetMoveLength()));
+
+	if (bWasMoving)
+	{
+		BP_OnMoveFinished();
+	}
+
+	// only the server tracks the interaction state
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// round trips always end back at the start
+	bAtTarget = !bReturnToStart && !bReversed;
+
+	ResetInteraction();
+}
+
+float ASideScrollingMovingPlatform::GetMoveLength() const
+{
+	return bReturnToStart ? MoveDuration * 2.0f : MoveDuration;
+}
+
+FVector ASideScrollingMovingPlatform::EvaluateLocation(float Elapsed) const
+{
+	// get the normalized move time
+	float Alpha = MoveDuration > 0.0f ? Elapsed / MoveDuration : 1.0f;
+
+	// round trips play the second half backwards
+	if (bReturnToStart && Alpha > 1.0f)
+	{
+		Alpha = 2.0f - Alpha;
+	}
+
+	Alpha = FMath::Clamp(Alpha, 0.0f, 1.0f);
+
+	if (bReversed)
+	{
+		Alpha = 1.0f - Alpha;
+	}
+
+	// ease the movement
+	Alpha = MoveCurve ? MoveCurve->GetFloatValue(Alpha) : FMath::SmoothStep(0.0f, 1.0f, Alpha);
+
+	return FMath::Lerp(PlatformStart, PlatformTarget, Alpha);
+}
+
+float ASideScrollingMovingPlatform::GetServerTime() const
+{
+	// use the game state's synchronized clock if we have one
+	if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		return float(GameState->GetServerWorldTimeSeconds());
+	}
+
+	return float(GetWorld()->GetTimeSeconds());
+}
@@ -7,17 +7,21 @@
 #include "SideScrollingInteractable.h"
 #include "SideScrollingMovingPlatform.generated.h"
 
+class UCurveFloat;
+
 /**
  *  Simple moving platform that can be triggered through interactions by other actors.
- *  The actual movement is performed by Blueprint code through latent execution nodes.
+ *  Movement is evaluated natively from a replicated server start time, so every machine
+ *  computes the same platform location without replicating it every tick.
+ *  The platform only ticks while it's moving. Blueprint code can add cosmetics through the move events, but can't replace the move.
  */
 UCLASS(abstract)
 class ASideScrollingMovingPlatform : public AActor, public ISideScrollingInteractable
 {
 	GENERATED_BODY()
-	
-public:	
-	
+
+public:
+
 	/** Constructor */
 	ASideScrollingMovingPlatform();
 
@@ -38,23 +42,84 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Moving Platform")
 	bool bOneShot = false;
 
+	/** If this is true, the platform will move back to its starting location after reaching the destination. Otherwise, each move toggles between both ends */
+	UPROPERTY(EditAnywhere, Category="Moving Platform")
+	bool bReturnToStart = false;
+
+	/** Optional easing curve. Maps normalized move time to normalized distance. A smooth step is used if not set */
+	UPROPERTY(EditAnywhere, Category="Moving Platform")
+	TObjectPtr<UCurveFloat> MoveCurve;
+
+	/** Starting location of the platform in world space */
+	FVector PlatformStart;
+
+	/** Server world time at which the current move started. Negative if the platform has never moved */
+	UPROPERTY(ReplicatedUsing = OnRep_MoveStartTime)
+	float MoveStartTime = -1.0f;
+
+	/** If this is true, the current move goes from the destination back to the starting location */
+	UPROPERTY(Replicated)
+	bool bReversed = false;
+
+	/** If this is true, the platform is resting at its destination. Server only */
+	bool bAtTarget = false;
+
 public:
 
-// ~begin IInteractable interface 
+// ~begin IInteractable interface
 
 	/** Performs an interaction triggered by another actor */
 	virtual void Interaction(AActor* Interactor) override;
 
 // ~end IInteractable interface
 
-	/** Resets the interaction state. Must be called from BP code to reset the platform */
+	/** Resets the interaction state. Called automatically when a move completes */
 	UFUNCTION(BlueprintCallable, Category="Moving Platform")
 	virtual void ResetInteraction();
 
 protected:
 
-	/** Allows Blueprint code to do the actual platform movement */
-	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category="Moving Platform", meta = (DisplayName="Move to Target"))
+	/** Starts moving the platform. Server only */
+	void MoveToTarget();
+
+	/** Passes control to BP to play cosmetic effects when a move starts. Called on every machine */
+	UFUNCTION(BlueprintImplementableEvent, Category="Moving Platform", meta = (DisplayName="On Move Started"))
+	void BP_OnMoveStarted();
+
+	/** Passes control to BP to play cosmetic effects when a move finishes. Called on every machine */
+	UFUNCTION(BlueprintImplementableEvent, Category="Moving Platform", meta = (DisplayName="On Move Finished"))
+	void BP_OnMoveFinished();
+
+	/** No longer called. Existing implementations move the platform on the server only, which clients wouldn't see. Use On Move Started for cosmetics instead */
+	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category="Moving Platform", meta = (DisplayName="Move to Target", DeprecatedFunction, DeprecationMessage = "The platform moves natively. Move cosmetic effects to On Move Started and remove the movement nodes"))
 	void BP_MoveToTarget();
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Moves the platform while a move is in progress */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Starts evaluating a move received from the server */
+	UFUNCTION()
+	void OnRep_MoveStartTime();
+
+	/** Enables ticking and snaps the platform to the current move location */
+	void StartMove();
+
+	/** Disables ticking and leaves the platform at the end of the move */
+	void FinishMove();
+
+	/** Returns the total time the current move takes */
+	float GetMoveLength() const;
+
+	/** Returns the platform location after the provided time into the current move */
+	FVector EvaluateLocation(float Elapsed) const;
+
+	/** Returns the server's world time, as estimated on this machine */
+	float GetServerTime() const;
+
 };
@@ -3,7 +3,7 @@
 
 #include "SideScrollingPickup.h"
 #include "GameFramework/Character.h"
-#include "SideScrollingGameMode.h"
+#include "SideScrollingPickupSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/SceneComponent.h"
 #include "Engine/World.h"
@@ -30,6 +30,27 @@ ASideScrollingPickup::ASideScrollingPickup()
 	OnActorBeginOverlap.AddDynamic(this, &ASideScrollingPickup::BeginOverlap);
 }
 
+void ASideScrollingPickup::SetPickupId(FName LevelName, int32 Index)
+{
+	PickupLevelName = LevelName;
+	PickupIndex = Index;
+}
+
+void ASideScrollingPickup::SetCollected(bool bNewCollected)
+{
+	bCollected = bNewCollected;
+
+	// hide the pickup and disable collision so we don't get picked up again
+	SetActorHiddenInGame(bCollected);
+	SetActorEnableCollision(!bCollected);
+
+	// play the pickup effects. The pickup stays alive so it can be recycled
+	if (bCollected)
+	{
+		BP_PlayPickupEffects();
+	}
+}
+
 void ASideScrollingPickup::BeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
 {
 	// have we collided against a character?
@@ -38,18 +59,20 @@ void ASideScrollingPickup::BeginOverlap(AActor* OverlappedActor, AActor* OtherAc
 		// is this the player character?
 		if (OverlappedCharacter->IsPlayerControlled())
 		{
-			// get the game mode
-			if (ASideScrollingGameMode* GM = Cast<ASideScrollingGameMode>(GetWorld()->GetAuthGameMode()))
+			// get the pickup subsystem
+			if (USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>())
 			{
-				// tell the game mode to process a pickup
-				GM->ProcessPickup();
+				if (GetNetMode() != NM_Client)
+				{
+					// collect the pickup for the player
+					Pickups->CollectPickup(this, OverlappedCharacter->GetController());
 
-				// disable collision so we don't get picked up again
-				SetActorEnableCollision(false);
+				} else if (OverlappedCharacter->IsLocallyControlled()) {
 
-				// Call the BP handler. It will be responsible for destroying the pickup
-				BP_OnPickedUp();
+					// hide the pickup right away for the local player
+					Pickups->PredictPickup(this);
+				}
 			}
 		}
 	}
-}
\ No newline at end of file
+}
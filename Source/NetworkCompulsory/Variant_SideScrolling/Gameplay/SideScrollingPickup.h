@@ -10,7 +10,8 @@ class USphereComponent;
 
 /**
  *  A simple side scrolling game pickup
- *  Increments a counter on the GameMode
+ *  Collected by the server through the pickup subsystem, which awards it to the player
+ *  Collected pickups are deactivated and pooled, and the subsystem reuses them to show other pickups
  */
 UCLASS(abstract)
 class ASideScrollingPickup : public AActor
@@ -26,13 +27,45 @@ public:
 	/** Constructor */
 	ASideScrollingPickup();
 
+protected:
+
+	/** Network stable name of the level this pickup was indexed in */
+	FName PickupLevelName;
+
+	/** Id of this pickup within its level. INDEX_NONE if it wasn't indexed */
+	int32 PickupIndex = INDEX_NONE;
+
+	/** If true, this actor has been collected and is waiting in the pool to be reused */
+	bool bCollected = false;
+
+public:
+
+	/** Sets the id assigned by the pickup subsystem */
+	void SetPickupId(FName LevelName, int32 Index);
+
+	/** Returns the name of the level this pickup was indexed in */
+	FName GetPickupLevelName() const { return PickupLevelName; }
+
+	/** Returns the id of this pickup within its level */
+	int32 GetPickupIndex() const { return PickupIndex; }
+
+	/** Returns true if this pickup has been collected */
+	bool IsCollected() const { return bCollected; }
+
+	/** Deactivates or reactivates the pickup */
+	void SetCollected(bool bNewCollected);
+
 protected:
 
 	/** Handles pickup collision */
 	UFUNCTION()
 	void BeginOverlap(AActor* OverlappedActor, AActor* OtherActor);
 
-	/** Passes control to BP to play effects on pickup */
-	UFUNCTION(BlueprintImplementableEvent, Category="Pickup", meta = (DisplayName = "On Picked Up"))
+	/** Passes control to BP to play effects on pickup. The pickup is pooled, so it must not be destroyed here */
+	UFUNCTION(BlueprintImplementableEvent, Category="Pickup", meta = (DisplayName = "Play Pickup Effects"))
+	void BP_PlayPickupEffects();
+
+	/** No longer called. Existing implementations destroy the actor, which would bypass the pool. Use Play Pickup Effects instead */
+	UFUNCTION(BlueprintImplementableEvent, Category="Pickup", meta = (DisplayName = "On Picked Up", DeprecatedFunction, DeprecationMessage = "The pickup is pooled. Move the effects to Play Pickup Effects and don't destroy the actor"))
 	void BP_OnPickedUp();
 };
@@ -0,0 +1,287 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingPickupField.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "SideScrollingPickupSubsystem.h"
+#include "SideScrollingGameState.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+
+ASideScrollingPickupField::ASideScrollingPickupField()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// create the instanced mesh. It's only used for rendering
+	Instances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Instances"));
+	RootComponent = Instances;
+
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetGenerateOverlapEvents(false);
+	Instances->SetCanEverAffectNavigation(false);
+}
+
+bool ASideScrollingPickupField::IsInstanceCollected(int32 InstanceIndex) const
+{
+	return FSideScrollingPickupLevelState::IsBitSet(CollectedBits, InstanceIndex);
+}
+
+void ASideScrollingPickupField::ApplyCollectedBits(const TArray<uint32>& NewConfirmedBits)
+{
+	const int32 NumWords = FMath::Max(NewConfirmedBits.Num(), ConfirmedBits.Num());
+	bool bChanged = false;
+
+	// only visit the instances whose bits changed since the last update
+	for (int32 Word = 0; Word < NumWords; ++Word)
+	{
+		const uint32 NewBits = NewConfirmedBits.IsValidIndex(Word) ? NewConfirmedBits[Word] : 0;
+		const uint32 OldBits = ConfirmedBits.IsValidIndex(Word) ? ConfirmedBits[Word] : 0;
+
+		uint32 ChangedBits = NewBits ^ OldBits;
+
+		while (ChangedBits != 0)
+		{
+			const uint32 Bit = FMath::CountTrailingZeros(ChangedBits);
+			ChangedBits &= ChangedBits - 1;
+
+			const int32 InstanceIndex = Word * 32 + Bit;
+
+			if (!InstanceLocations.IsValidIndex(InstanceIndex))
+			{
+				continue;
+			}
+
+			const bool bCollected = (NewBits & (1u << Bit)) != 0;
+
+			// skip instances we already predicted
+			if (bCollected == IsInstanceCollected(InstanceIndex))
+			{
+				continue;
+			}
+
+			SetInstanceHidden(InstanceIndex, bCollected);
+			bChanged = true;
+
+			if (bCollected)
+			{
+				BP_OnInstancePickedUp(InstanceLocations[InstanceIndex]);
+			}
+		}
+	}
+
+	ConfirmedBits = NewConfirmedBits;
+
+	if (bChanged)
+	{
+		Instances->MarkRenderStateDirty();
+
+		// only tick while there's something left to collect
+		SetActorTickEnabled(NumCollected < InstanceLocations.Num());
+	}
+}
+
+void ASideScrollingPickupField::CollectInstance(int32 InstanceIndex, bool bPredicted)
+{
+	if (!InstanceLocations.IsValidIndex(InstanceIndex))
+	{
+		return;
+	}
+
+	// the server's own changes are confirmed right away
+	if (!bPredicted)
+	{
+		FSideScrollingPickupLevelState::SetBit(ConfirmedBits, InstanceIndex);
+	}
+
+	if (IsInstanceCollected(InstanceIndex))
+	{
+		return;
+	}
+
+	// hide the instance and play the pickup effects
+	SetInstanceHidden(InstanceIndex, true);
+	Instances->MarkRenderStateDirty();
+
+	BP_OnInstancePickedUp(InstanceLocations[InstanceIndex]);
+
+	// stop testing once everything has been collected
+	if (NumCollected >= InstanceLocations.Num())
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ASideScrollingPickupField::RollbackInstance(int32 InstanceIndex)
+{
+	// leave confirmed instances and instances that were already restored alone
+	if (!InstanceLocations.IsValidIndex(InstanceIndex) || !IsInstanceCollected(InstanceIndex) || FSideScrollingPickupLevelState::IsBitSet(ConfirmedBits, InstanceIndex))
+	{
+		return;
+	}
+
+	// show the instance again and resume testing
+	SetInstanceHidden(InstanceIndex, false);
+	Instances->MarkRenderStateDirty();
+
+	SetActorTickEnabled(true);
+}
+
+void ASideScrollingPickupField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const int32 NumInstances = Instances->GetInstanceCount();
+
+	// cache the instance transforms
+	InstanceLocations.SetNumUninitialized(NumInstances);
+	InstanceTransforms.SetNumUninitialized(NumInstances);
+
+	FBox Bounds(ForceInit);
+
+	for (int32 i = 0; i < NumInstances; ++i)
+	{
+		FTransform WorldTransform;
+
+		Instances->GetInstanceTransform(i, InstanceTransforms[i], false);
+		Instances->GetInstanceTransform(i, WorldTransform, true);
+
+		InstanceLocations[i] = WorldTransform.GetLocation();
+		Bounds += InstanceLocations[i];
+	}
+
+	// sort the instances along the longest axis of the field, so we can find the ones near a player with a binary search
+	const FVector Size = Bounds.IsValid ? Bounds.GetSize() : FVector::ZeroVector;
+	SortAxis = Size.X >= Size.Y && Size.X >= Size.Z ? 0 : (Size.Y >= Size.Z ? 1 : 2);
+
+	SortedInstances.SetNumUninitialized(NumInstances);
+
+	for (int32 i = 0; i < NumInstances; ++i)
+	{
+		SortedInstances[i] = i;
+	}
+
+	SortedInstances.Sort([this](int32 A, int32 B) { return InstanceLocations[A][SortAxis] < InstanceLocations[B][SortAxis]; });
+
+	SortedKeys.SetNumUninitialized(NumInstances);
+
+	for (int32 i = 0; i < NumInstances; ++i)
+	{
+		SortedKeys[i] = InstanceLocations[SortedInstances[i]][SortAxis];
+	}
+
+	CollectedBits.Init(0, FMath::DivideAndRoundUp(NumInstances, 32));
+	NumCollected = 0;
+
+	// nothing to test if the field is empty
+	SetActorTickEnabled(NumInstances > 0);
+
+	// register with the pickup subsystem so our collected state is replicated
+	PickupSetName = FName(*FString::Printf(TEXT("%s.%s"), *USideScrollingPickupSubsystem::GetPickupLevelName(GetLevel()).ToString(), *GetName()));
+
+	if (USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>())
+	{
+		Pickups->RegisterField(this);
+	}
+}
+
+void ASideScrollingPickupField::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>())
+	{
+		Pickups->UnregisterField(this);
+	}
+}
+
+void ASideScrollingPickupField::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// the server tests all players, clients only predict for their local players
+	const bool bIsClient = GetNetMode() == NM_Client;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+
+		if (!PC || (bIsClient && !PC->IsLocalController()))
+		{
+			continue;
+		}
+
+		if (APawn* Pawn = PC->GetPawn())
+		{
+			CollectTouchedInstances(Pawn);
+		}
+	}
+}
+
+void ASideScrollingPickupField::CollectTouchedInstances(APawn* Pawn)
+{
+	USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>();
+
+	if (!Pickups)
+	{
+		return;
+	}
+
+	// get the pawn's capsule as a vertical segment and a radius
+	float CapsuleRadius = 0.0f;
+	float CapsuleHalfHeight = 0.0f;
+
+	Pawn->GetSimpleCollisionCylinder(CapsuleRadius, CapsuleHalfHeight);
+
+	const FVector Center = Pawn->GetActorLocation();
+	const FVector SegmentOffset(0.0f, 0.0f, FMath::Max(CapsuleHalfHeight - CapsuleRadius, 0.0f));
+
+	const float Reach = CapsuleRadius + PickupRadius;
+	const float ReachSquared = Reach * Reach;
+
+	// find the range of instances within reach along the sort axis
+	const float AxisReach = Reach + FMath::Abs(SegmentOffset[SortAxis]);
+	const float AxisCenter = Center[SortAxis];
+
+	for (int32 i = Algo::LowerBound(SortedKeys, AxisCenter - AxisReach); i < SortedKeys.Num() && SortedKeys[i] <= AxisCenter + AxisReach; ++i)
+	{
+		const int32 InstanceIndex = SortedInstances[i];
+
+		if (IsInstanceCollected(InstanceIndex))
+		{
+			continue;
+		}
+
+		// is the pickup touching the capsule?
+		if (FMath::PointDistToSegmentSquared(InstanceLocations[InstanceIndex], Center - SegmentOffset, Center + SegmentOffset) <= ReachSquared)
+		{
+			Pickups->CollectFieldPickup(this, InstanceIndex, Pawn->GetController());
+		}
+	}
+}
+
+void ASideScrollingPickupField::SetInstanceHidden(int32 InstanceIndex, bool bHidden)
+{
+	// update the collected bits
+	if (bHidden)
+	{
+		FSideScrollingPickupLevelState::SetBit(CollectedBits, InstanceIndex);
+		++NumCollected;
+
+	} else {
+
+		FSideScrollingPickupLevelState::ClearBit(CollectedBits, InstanceIndex);
+		--NumCollected;
+	}
+
+	// hide collected instances by scaling them down to nothing
+	FTransform InstanceTransform = InstanceTransforms[InstanceIndex];
+
+	if (bHidden)
+	{
+		InstanceTransform.SetScale3D(FVector::ZeroVector);
+	}
+
+	Instances->UpdateInstanceTransform(InstanceIndex, InstanceTransform, false, false, true);
+}
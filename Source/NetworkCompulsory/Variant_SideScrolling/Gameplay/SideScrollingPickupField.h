@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SideScrollingPickupField.generated.h"
+
+class UInstancedStaticMeshComponent;
+class APawn;
+
+/**
+ *  A region of side scrolling pickups rendered through a single instanced static mesh.
+ *  Each mesh instance is a pickup:
+ *  - Collection is a distance test between the instances and the player capsules, with no overlap components
+ *  - Instances are sorted along the field's longest axis, so each player only tests the pickups near it
+ *  - Collected instances are hidden by index, and their state is replicated through the pickup subsystem
+ */
+UCLASS(abstract)
+class ASideScrollingPickupField : public AActor
+{
+	GENERATED_BODY()
+
+	/** Pickup instances. Add an instance per pickup in the editor */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
+	UInstancedStaticMeshComponent* Instances;
+
+public:
+
+	/** Constructor */
+	ASideScrollingPickupField();
+
+protected:
+
+	/** Distance from the player capsule at which a pickup is collected */
+	UPROPERTY(EditAnywhere, Category="Pickup", meta = (ClampMin = 0, ClampMax = 1000, Units="cm"))
+	float PickupRadius = 50.0f;
+
+	/** Network stable name used to replicate this field's collected state */
+	FName PickupSetName;
+
+	/** World space location of each instance */
+	TArray<FVector> InstanceLocations;
+
+	/** Original relative transform of each instance, so hidden instances can be restored */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Instance indices sorted along the sort axis */
+	TArray<int32> SortedInstances;
+
+	/** Sort axis coordinate for each entry in SortedInstances */
+	TArray<float> SortedKeys;
+
+	/** Axis the instances are sorted along */
+	int32 SortAxis = 0;
+
+	/** Locally collected bitfield, one bit per instance. Includes predicted pickups */
+	TArray<uint32> CollectedBits;
+
+	/** Collected bitfield last confirmed by the server */
+	TArray<uint32> ConfirmedBits;
+
+	/** Number of collected instances */
+	int32 NumCollected = 0;
+
+public:
+
+	/** Returns the name used to replicate this field's collected state */
+	FName GetPickupSetName() const { return PickupSetName; }
+
+	/** Returns true if the instance has been collected */
+	bool IsInstanceCollected(int32 InstanceIndex) const;
+
+	/** Hides or restores the instances whose confirmed collected state changed */
+	void ApplyCollectedBits(const TArray<uint32>& NewConfirmedBits);
+
+	/** Hides a single collected instance. Predicted pickups wait for the server to confirm them */
+	void CollectInstance(int32 InstanceIndex, bool bPredicted);
+
+	/** Shows a predicted instance again if the server didn't confirm it */
+	void RollbackInstance(int32 InstanceIndex);
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Tests player pawns against the pickups */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Collects all pickups touched by the provided pawn */
+	void CollectTouchedInstances(APawn* Pawn);
+
+	/** Hides or restores an instance without updating the render state */
+	void SetInstanceHidden(int32 InstanceIndex, bool bHidden);
+
+	/** Passes control to BP to play effects on pickup */
+	UFUNCTION(BlueprintImplementableEvent, Category="Pickup", meta = (DisplayName = "On Instance Picked Up"))
+	void BP_OnInstancePickedUp(const FVector& Location);
+};
@@ -0,0 +1,558 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingPickupSubsystem.h"
+#include "SideScrollingPickup.h"
+#include "SideScrollingPickupField.h"
+#include "SideScrollingGameMode.h"
+#include "SideScrollingGameState.h"
+#include "GameFramework/Controller.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+
+FName USideScrollingPickupSubsystem::GetPickupLevelName(const ULevel* Level)
+{
+	// strip the PIE prefix so all PIE instances agree on the name
+	return Level ? FName(UWorld::RemovePIEPrefix(Level->GetPackage()->GetName())) : NAME_None;
+}
+
+void USideScrollingPickupSubsystem::CollectPickup(ASideScrollingPickup* Pickup, AController* Collector)
+{
+	// only the server can collect pickups
+	ASideScrollingGameMode* GM = Cast<ASideScrollingGameMode>(GetWorld()->GetAuthGameMode());
+
+	if (!Pickup || !GM)
+	{
+		return;
+	}
+
+	ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>();
+	const int32 PickupIndex = Pickup->GetPickupIndex();
+
+	// indexed pickups are tracked in the replicated bitfield
+	if (GS && PickupIndex != INDEX_NONE)
+	{
+		// ignore pickups that were already collected by another player
+		if (!GS->MarkPickupCollected(Pickup->GetPickupLevelName(), PickupIndex))
+		{
+			return;
+		}
+
+		// the server applies its own changes right away
+		if (FPickupLevel* PickupLevel = Levels.Find(Pickup->GetPickupLevelName()))
+		{
+			FSideScrollingPickupLevelState::SetBit(PickupLevel->AppliedBits, PickupIndex);
+
+			ReleasePickup(Pickup->GetPickupLevelName(), *PickupLevel, PickupIndex);
+		}
+
+	} else if (Pickup->IsCollected()) {
+
+		return;
+
+	} else {
+
+		// pickups that weren't indexed stay hidden until the pickups are reset
+		Pickup->SetCollected(true);
+
+		CollectedPickups.Add(Pickup);
+	}
+
+	// award the pickup to the player
+	GM->ProcessPickup(Collector);
+}
+
+void USideScrollingPickupSubsystem::PredictPickup(ASideScrollingPickup* Pickup)
+{
+	// the server will confirm the pickup through the replicated bitfield
+	if (!Pickup || Pickup->IsCollected() || GetWorld()->GetNetMode() != NM_Client)
+	{
+		return;
+	}
+
+	// only indexed pickups can be confirmed, so only those are predicted
+	const FName LevelName = Pickup->GetPickupLevelName();
+	const int32 PickupIndex = Pickup->GetPickupIndex();
+
+	FPickupLevel* PickupLevel = Levels.Find(LevelName);
+
+	if (!PickupLevel || PickupIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	ReleasePickup(LevelName, *PickupLevel, PickupIndex);
+
+	PredictedPickups.Add({ LevelName, PickupIndex, GetWorld()->GetTimeSeconds() });
+
+	StartPredictionTimer();
+}
+
+void USideScrollingPickupSubsystem::StartPredictionTimer()
+{
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		if (!Timers->IsTimerActive(PredictionTimer))
+		{
+			Timers->SetTimer(PredictionTimer, this, &USideScrollingPickupSubsystem::CheckPredictedPickups, PredictionTimeout);
+		}
+	}
+}
+
+void USideScrollingPickupSubsystem::CheckPredictedPickups()
+{
+	const ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>();
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	float NextCheckDelay = -1.0f;
+
+	for (int32 i = PredictedPickups.Num() - 1; i >= 0; --i)
+	{
+		const FPredictedPickup& Prediction = PredictedPickups[i];
+		FPickupLevel* PickupLevel = Levels.Find(Prediction.LevelName);
+
+		// drop pickups whose level went away or that were confirmed by the server
+		const TArray<uint32>* CollectedBits = (PickupLevel && GS) ? GS->FindCollectedPickups(Prediction.LevelName) : nullptr;
+
+		if (!PickupLevel || (CollectedBits && FSideScrollingPickupLevelState::IsBitSet(*CollectedBits, Prediction.PickupIndex)))
+		{
+			PredictedPickups.RemoveAtSwap(i);
+			continue;
+		}
+
+		const float TimeLeft = Prediction.PredictedTime + PredictionTimeout - Now;
+
+		if (TimeLeft > 0.0f)
+		{
+			NextCheckDelay = NextCheckDelay < 0.0f ? TimeLeft : FMath::Min(NextCheckDelay, TimeLeft);
+			continue;
+		}
+
+		// the server rejected the pickup, so show it again
+		AcquirePickup(Prediction.LevelName, *PickupLevel, Prediction.PickupIndex);
+
+		PredictedPickups.RemoveAtSwap(i);
+	}
+
+	for (int32 i = PredictedFieldPickups.Num() - 1; i >= 0; --i)
+	{
+		const FPredictedFieldPickup& Prediction = PredictedFieldPickups[i];
+		ASideScrollingPickupField* Field = Prediction.Field.Get();
+
+		// drop instances whose field went away or that were confirmed by the server
+		const TArray<uint32>* CollectedBits = (Field && GS) ? GS->FindCollectedPickups(Field->GetPickupSetName()) : nullptr;
+
+		if (!Field || (CollectedBits && FSideScrollingPickupLevelState::IsBitSet(*CollectedBits, Prediction.InstanceIndex)))
+		{
+			PredictedFieldPickups.RemoveAtSwap(i);
+			continue;
+		}
+
+		const float TimeLeft = Prediction.PredictedTime + PredictionTimeout - Now;
+
+		if (TimeLeft > 0.0f)
+		{
+			NextCheckDelay = NextCheckDelay < 0.0f ? TimeLeft : FMath::Min(NextCheckDelay, TimeLeft);
+			continue;
+		}
+
+		// the server rejected the pickup, so show the instance again
+		Field->RollbackInstance(Prediction.InstanceIndex);
+
+		PredictedFieldPickups.RemoveAtSwap(i);
+	}
+
+	// keep checking any predictions that are still pending
+	if (NextCheckDelay > 0.0f)
+	{
+		if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+		{
+			Timers->SetTimer(PredictionTimer, this, &USideScrollingPickupSubsystem::CheckPredictedPickups, NextCheckDelay);
+		}
+	}
+}
+
+void USideScrollingPickupSubsystem::RegisterField(ASideScrollingPickupField* Field)
+{
+	if (!Field)
+	{
+		return;
+	}
+
+	Fields.AddUnique(Field);
+
+	// hide anything that was collected before the field began play
+	if (const ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>())
+	{
+		if (const TArray<uint32>* CollectedBits = GS->FindCollectedPickups(Field->GetPickupSetName()))
+		{
+			Field->ApplyCollectedBits(*CollectedBits);
+		}
+	}
+}
+
+void USideScrollingPickupSubsystem::UnregisterField(ASideScrollingPickupField* Field)
+{
+	Fields.RemoveSwap(Field);
+}
+
+void USideScrollingPickupSubsystem::CollectFieldPickup(ASideScrollingPickupField* Field, int32 InstanceIndex, AController* Collector)
+{
+	if (!Field)
+	{
+		return;
+	}
+
+	// clients hide the instance right away and wait for the replicated bitfield
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		if (Field->IsInstanceCollected(InstanceIndex))
+		{
+			return;
+		}
+
+		Field->CollectInstance(InstanceIndex, true);
+
+		PredictedFieldPickups.Add({ Field, InstanceIndex, GetWorld()->GetTimeSeconds() });
+
+		StartPredictionTimer();
+		return;
+	}
+
+	ASideScrollingGameMode* GM = Cast<ASideScrollingGameMode>(GetWorld()->GetAuthGameMode());
+
+	if (!GM)
+	{
+		return;
+	}
+
+	// ignore instances that were already collected by another player
+	if (ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>())
+	{
+		if (!GS->MarkPickupCollected(Field->GetPickupSetName(), InstanceIndex))
+		{
+			return;
+		}
+
+	} else if (Field->IsInstanceCollected(InstanceIndex)) {
+
+		return;
+	}
+
+	Field->CollectInstance(InstanceIndex, false);
+
+	// award the pickup to the player
+	GM->ProcessPickup(Collector);
+}
+
+void USideScrollingPickupSubsystem::ApplyCollectedState()
+{
+	const ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>();
+
+	if (!GS)
+	{
+		return;
+	}
+
+	static const TArray<uint32> NoneCollected;
+
+	for (TPair<FName, FPickupLevel>& Pair : Levels)
+	{
+		const TArray<uint32>* CollectedBits = GS->FindCollectedPickups(Pair.Key);
+
+		ApplyLevelState(Pair.Key, Pair.Value, CollectedBits ? *CollectedBits : NoneCollected);
+	}
+
+	for (const TWeakObjectPtr<ASideScrollingPickupField>& Field : Fields)
+	{
+		if (Field.IsValid())
+		{
+			const TArray<uint32>* CollectedBits = GS->FindCollectedPickups(Field->GetPickupSetName());
+
+			Field->ApplyCollectedBits(CollectedBits ? *CollectedBits : NoneCollected);
+		}
+	}
+}
+
+void USideScrollingPickupSubsystem::ResetPickups()
+{
+	ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>();
+
+	if (!GS || !GS->HasAuthority())
+	{
+		return;
+	}
+
+	// clear the replicated state and restore the indexed pickups
+	GS->ClearCollectedPickups();
+
+	ApplyCollectedState();
+
+	// restore any pickups that weren't indexed
+	for (const TWeakObjectPtr<ASideScrollingPickup>& Pickup : CollectedPickups)
+	{
+		if (Pickup.IsValid())
+		{
+			Pickup->SetCollected(false);
+		}
+	}
+
+	CollectedPickups.Reset();
+}
+
+void USideScrollingPickupSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// subscribe to streaming level changes
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USideScrollingPickupSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &USideScrollingPickupSubsystem::OnLevelRemoved);
+}
+
+void USideScrollingPickupSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	Levels.Empty();
+	PickupClasses.Empty();
+	CollectedPickups.Empty();
+	PredictedPickups.Empty();
+	PredictedFieldPickups.Empty();
+	Fields.Empty();
+
+	Super::Deinitialize();
+}
+
+void USideScrollingPickupSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// index the persistent level and any levels that were already loaded
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		IndexLevel(Level);
+	}
+}
+
+bool USideScrollingPickupSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USideScrollingPickupSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == GetWorld())
+	{
+		IndexLevel(Level);
+	}
+}
+
+void USideScrollingPickupSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// a null level means every level is being removed
+	if (Level)
+	{
+		Levels.Remove(GetPickupLevelName(Level));
+
+	} else {
+
+		Levels.Empty();
+	}
+
+	// drop collected pickups that went away with the level
+	CollectedPickups.RemoveAll([Level](const TWeakObjectPtr<ASideScrollingPickup>& Pickup)
+	{
+		return !Pickup.IsValid() || !Level || Pickup->GetLevel() == Level;
+	});
+}
+
+void USideScrollingPickupSubsystem::IndexLevel(ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	const FName LevelName = GetPickupLevelName(Level);
+
+	FPickupLevel& PickupLevel = Levels.FindOrAdd(LevelName);
+	PickupLevel.Level = Level;
+	PickupLevel.Slots.Reset();
+	PickupLevel.FreePickups.Reset();
+	PickupLevel.AppliedBits.Reset();
+
+	TArray<ASideScrollingPickup*> LevelPickups;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (ASideScrollingPickup* Pickup = Cast<ASideScrollingPickup>(Actor))
+		{
+			LevelPickups.Add(Pickup);
+		}
+	}
+
+	// sort the pickups by name, so every machine assigns the same ids regardless of load order
+	LevelPickups.Sort([](const ASideScrollingPickup& A, const ASideScrollingPickup& B)
+	{
+		return A.GetFName().Compare(B.GetFName()) < 0;
+	});
+
+	// remember where each pickup was placed, so any pooled actor can show it later
+	PickupLevel.Slots.SetNum(LevelPickups.Num());
+
+	for (int32 i = 0; i < LevelPickups.Num(); ++i)
+	{
+		FPickupSlot& Slot = PickupLevel.Slots[i];
+		Slot.Pickup = LevelPickups[i];
+		Slot.Class = LevelPickups[i]->GetClass();
+		Slot.Transform = LevelPickups[i]->GetActorTransform();
+
+		PickupClasses.AddUnique(Slot.Class);
+
+		LevelPickups[i]->SetPickupId(LevelName, i);
+	}
+
+	// hide anything that was collected before the level was indexed
+	if (const ASideScrollingGameState* GS = GetWorld()->GetGameState<ASideScrollingGameState>())
+	{
+		if (const TArray<uint32>* CollectedBits = GS->FindCollectedPickups(LevelName))
+		{
+			ApplyLevelState(LevelName, PickupLevel, *CollectedBits);
+		}
+	}
+}
+
+void USideScrollingPickupSubsystem::ApplyLevelState(FName LevelName, FPickupLevel& PickupLevel, const TArray<uint32>& CollectedBits)
+{
+	const int32 NumWords = FMath::Max(CollectedBits.Num(), PickupLevel.AppliedBits.Num());
+
+	// only visit the pickups whose bits changed since the last update
+	for (int32 Word = 0; Word < NumWords; ++Word)
+	{
+		const uint32 NewBits = CollectedBits.IsValidIndex(Word) ? CollectedBits[Word] : 0;
+		const uint32 OldBits = PickupLevel.AppliedBits.IsValidIndex(Word) ? PickupLevel.AppliedBits[Word] : 0;
+
+		uint32 ChangedBits = NewBits ^ OldBits;
+
+		while (ChangedBits != 0)
+		{
+			const uint32 Bit = FMath::CountTrailingZeros(ChangedBits);
+			ChangedBits &= ChangedBits - 1;
+
+			const int32 PickupIndex = Word * 32 + Bit;
+
+			if (NewBits & (1u << Bit))
+			{
+				ReleasePickup(LevelName, PickupLevel, PickupIndex);
+
+			} else {
+
+				AcquirePickup(LevelName, PickupLevel, PickupIndex);
+			}
+		}
+	}
+
+	PickupLevel.AppliedBits = CollectedBits;
+}
+
+void USideScrollingPickupSubsystem::ReleasePickup(FName LevelName, FPickupLevel& PickupLevel, int32 PickupIndex)
+{
+	if (!PickupLevel.Slots.IsValidIndex(PickupIndex))
+	{
+		return;
+	}
+
+	// ignore pickups that were already released, e.g. through prediction
+	FPickupSlot& Slot = PickupLevel.Slots[PickupIndex];
+	ASideScrollingPickup* Pickup = Slot.Pickup.Get();
+
+	if (!Pickup)
+	{
+		return;
+	}
+
+	// hide the actor and return it to the pool. It no longer stands for this pickup
+	Pickup->SetCollected(true);
+	Pickup->SetPickupId(LevelName, INDEX_NONE);
+
+	Slot.Pickup.Reset();
+
+	PickupLevel.FreePickups.Add(Pickup);
+
+	// destroy the oldest pooled actors once the pool is full. Their pickup effects have had time to play
+	while (PickupLevel.FreePickups.Num() > MaxPooledPickups)
+	{
+		if (ASideScrollingPickup* OldPickup = PickupLevel.FreePickups[0].Get())
+		{
+			OldPickup->Destroy();
+		}
+
+		PickupLevel.FreePickups.RemoveAt(0);
+	}
+}
+
+void USideScrollingPickupSubsystem::AcquirePickup(FName LevelName, FPickupLevel& PickupLevel, int32 PickupIndex)
+{
+	if (!PickupLevel.Slots.IsValidIndex(PickupIndex))
+	{
+		return;
+	}
+
+	// ignore pickups that are already shown
+	FPickupSlot& Slot = PickupLevel.Slots[PickupIndex];
+
+	if (Slot.Pickup.IsValid() || !Slot.Class)
+	{
+		return;
+	}
+
+	// reuse the oldest pooled actor of the same class
+	ASideScrollingPickup* Pickup = nullptr;
+
+	for (int32 i = 0; i < PickupLevel.FreePickups.Num(); ++i)
+	{
+		ASideScrollingPickup* FreePickup = PickupLevel.FreePickups[i].Get();
+
+		if (FreePickup && FreePickup->GetClass() == Slot.Class)
+		{
+			Pickup = FreePickup;
+			PickupLevel.FreePickups.RemoveAt(i);
+			break;
+		}
+	}
+
+	if (Pickup)
+	{
+		// move it while its collision is still off
+		Pickup->SetActorTransform(Slot.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+
+	} else {
+
+		// the pool is empty, so spawn a new actor into the pickup's level
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.OverrideLevel = PickupLevel.Level.Get();
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		Pickup = GetWorld()->SpawnActor<ASideScrollingPickup>(Slot.Class, Slot.Transform, SpawnParams);
+
+		if (!Pickup)
+		{
+			return;
+		}
+	}
+
+	Pickup->SetPickupId(LevelName, PickupIndex);
+
+	if (Pickup->IsCollected())
+	{
+		Pickup->SetCollected(false);
+	}
+
+	Slot.Pickup = Pickup;
+}
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTimerSubsystem.h"
+#include "SideScrollingPickupSubsystem.generated.h"
+
+class ASideScrollingPickup;
+class ASideScrollingPickupField;
+class AController;
+class ULevel;
+
+/**
+ *  Tracks side scrolling pickups per level.
+ *  - Pickups are indexed in a stable order when their level is added, so every machine agrees on their ids
+ *  - Collected state is replicated by the GameState as one bitfield per level instead of per pickup actor
+ *  - Collected pickup actors go back to a per-level pool and are reused for whichever pickup is shown next, so a level only
+ *    keeps as many pickup actors alive as are visible plus a small pool
+ *  - Instanced pickup fields replicate their collected instances through the same bitfields
+ */
+UCLASS()
+class USideScrollingPickupSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** An indexed pickup, and the actor currently showing it */
+	struct FPickupSlot
+	{
+		/** Actor showing this pickup. Null while the pickup is collected */
+		TWeakObjectPtr<ASideScrollingPickup> Pickup;
+
+		/** Pickup class, so any pooled actor of the same class can show this pickup */
+		UClass* Class = nullptr;
+
+		/** Where the pickup was placed in the level */
+		FTransform Transform;
+	};
+
+	/** Indexed pickups for a single level */
+	struct FPickupLevel
+	{
+		/** Level the pickups were placed in. Spawned pickups go into the same level */
+		TWeakObjectPtr<ULevel> Level;
+
+		/** Pickup slots, in id order */
+		TArray<FPickupSlot> Slots;
+
+		/** Collected pickup actors, waiting to be reused for another slot */
+		TArray<TWeakObjectPtr<ASideScrollingPickup>> FreePickups;
+
+		/** Collected bitfield last applied to the pickups */
+		TArray<uint32> AppliedBits;
+	};
+
+	/** Indexed levels, by network stable level name */
+	TMap<FName, FPickupLevel> Levels;
+
+	/** Classes of the indexed pickups, kept loaded so collected pickups can be respawned */
+	UPROPERTY()
+	TArray<TObjectPtr<UClass>> PickupClasses;
+
+	/** Most collected pickup actors kept for reuse in each level. Older ones are destroyed */
+	int32 MaxPooledPickups = 32;
+
+	/** Collected pickups that weren't indexed, hidden until pickups are reset */
+	TArray<TWeakObjectPtr<ASideScrollingPickup>> CollectedPickups;
+
+	/** An indexed pickup hidden ahead of server confirmation */
+	struct FPredictedPickup
+	{
+		/** Network stable name of the pickup's level */
+		FName LevelName;
+
+		/** Id of the pickup within its level */
+		int32 PickupIndex = INDEX_NONE;
+
+		/** Time the pickup was predicted */
+		float PredictedTime = 0.0f;
+	};
+
+	/** Indexed pickups hidden ahead of server confirmation */
+	TArray<FPredictedPickup> PredictedPickups;
+
+	/** A pickup field instance hidden ahead of server confirmation */
+	struct FPredictedFieldPickup
+	{
+		/** Field that owns the instance */
+		TWeakObjectPtr<ASideScrollingPickupField> Field;
+
+		/** Index of the predicted instance */
+		int32 InstanceIndex = INDEX_NONE;
+
+		/** Time the instance was predicted */
+		float PredictedTime = 0.0f;
+	};
+
+	/** Pickup field instances hidden ahead of server confirmation */
+	TArray<FPredictedFieldPickup> PredictedFieldPickups;
+
+	/** Time a predicted pickup waits for the server to confirm it before it's shown again */
+	float PredictionTimeout = 1.0f;
+
+	/** Timer that checks predicted pickups for confirmation */
+	FGameplayTimerHandle PredictionTimer;
+
+	/** Registered instanced pickup fields */
+	TArray<TWeakObjectPtr<ASideScrollingPickupField>> Fields;
+
+	/** Streaming level delegate handles */
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+public:
+
+	/** Returns a level name that matches across the server and clients */
+	static FName GetPickupLevelName(const ULevel* Level);
+
+	/** Collects a pickup on behalf of a player. Server only */
+	void CollectPickup(ASideScrollingPickup* Pickup, AController* Collector);
+
+	/** Hides a pickup overlapped by a locally controlled player ahead of server confirmation. Rolled back if the server doesn't confirm it */
+	void PredictPickup(ASideScrollingPickup* Pickup);
+
+	/** Starts replicating the collected state of an instanced pickup field */
+	void RegisterField(ASideScrollingPickupField* Field);
+
+	/** Stops tracking an instanced pickup field */
+	void UnregisterField(ASideScrollingPickupField* Field);
+
+	/** Collects a pickup field instance on behalf of a player. Clients only predict the pickup, and roll it back if the server doesn't confirm it */
+	void CollectFieldPickup(ASideScrollingPickupField* Field, int32 InstanceIndex, AController* Collector);
+
+	/** Applies the collected state replicated by the GameState to the indexed pickups */
+	void ApplyCollectedState();
+
+	/** Restores all collected pickups in the level. Called by the game mode when the level is reset. Server only */
+	void ResetPickups();
+
+	/** Initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	/** Indexes the pickups in the persistent level */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+
+	/** Only create this subsystem for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Indexes the pickups in a streamed in level */
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	/** Drops the pickups in a streamed out level */
+	void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+
+	/** Assigns ids to all pickups in the level and applies their collected state */
+	void IndexLevel(ULevel* Level);
+
+	/** Brings the pickups of a level in line with the provided collected bitfield */
+	void ApplyLevelState(FName LevelName, FPickupLevel& PickupLevel, const TArray<uint32>& CollectedBits);
+
+	/** Hides an indexed pickup and returns its actor to the level's pool */
+	void ReleasePickup(FName LevelName, FPickupLevel& PickupLevel, int32 PickupIndex);
+
+	/** Shows an indexed pickup, reusing a pooled actor of the same class or spawning one if the pool has none */
+	void AcquirePickup(FName LevelName, FPickupLevel& PickupLevel, int32 PickupIndex);
+
+	/** Starts checking predicted pickups for confirmation, unless a check is already pending */
+	void StartPredictionTimer();
+
+	/** Shows predicted pickups and field instances again if the server didn't confirm them in time */
+	void CheckPredictedPickups();
+};
@@ -8,10 +8,10 @@
 
 class USceneComponent;
 class UStaticMeshComponent;
-class UBoxComponent;
 
 /**
  *  A side scrolling game platform that the character can jump or drop through.
+ *  Pass-through is handled by the character's movement component, so the platform itself doesn't tick or track overlaps.
  */
 UCLASS(abstract)
 class ASideScrollingSoftPlatform : public AActor
@@ -26,21 +26,9 @@ class ASideScrollingSoftPlatform : public AActor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* Mesh;
 
-	/** Collision volume that toggles soft collision on the character when they're below the platform. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* CollisionCheckBox;
-
 public:	
 	
 	/** Constructor */
 	ASideScrollingSoftPlatform();
 
-protected:
-
-	/** Handles soft collision check box overlaps */
-	UFUNCTION()
-	void OnSoftCollisionOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	/** Restores soft collision state when overlap ends */
-	virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
 };
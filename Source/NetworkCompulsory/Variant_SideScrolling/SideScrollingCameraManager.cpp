@@ -3,12 +3,16 @@
 
 #include "SideScrollingCameraManager.h"
 #include "GameFramework/Pawn.h"
-#include "Engine/HitResult.h"
-#include "CollisionQueryParams.h"
-#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "SideScrollingCharacter.h"
+#include "EngineUtils.h"
+#include "NetworkCompulsory.h"
 
 void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_SideScrollingCamera);
+
 	// ensure the view target is a pawn
 	APawn* TargetPawn = Cast<APawn>(OutVT.Target);
 
@@ -17,7 +21,7 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 	{
 		// set the view target FOV and rotation
 		OutVT.POV.Rotation = FRotator(0.0f, -90.0f, 0.0f);
-		OutVT.POV.FOV = 65.0f;
+		OutVT.POV.FOV = CameraFOV;
 
 		// cache the current location
 		FVector CurrentActorLocation = OutVT.Target->GetActorLocation();
@@ -46,27 +50,40 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 			return;
 		}
 
+		// are we framing more than one player?
+		FBox PlayerBounds(ForceInit);
+
+		if (bFrameAllPlayers && GetFramedBounds(TargetPawn, PlayerBounds) > 1)
+		{
+			const FVector BoundsCenter = PlayerBounds.GetCenter();
+
+			// blend the height towards the center of the group
+			CurrentZ = FMath::FInterpTo(CurrentZ, BoundsCenter.Z, DeltaTime, 2.0f);
+
+			// pull back far enough to keep everyone on screen, and keep the center within the scrolling bounds
+			const FVector TargetCameraLocation(
+				FMath::Clamp(BoundsCenter.X, CameraXMinBounds, CameraXMaxBounds),
+				BoundsCenter.Y + GetFramingZoom(PlayerBounds),
+				CurrentZ);
+
+			OutVT.POV.Location = FMath::VInterpTo(CurrentCameraLocation, TargetCameraLocation, DeltaTime, 2.0f);
+
+			return;
+		}
+
 		// check if the camera needs to update its height
 		bool bZUpdate = false;
 
-		// is the character moving vertically?
-		if (FMath::IsNearlyZero(TargetPawn->GetVelocity().Z))
+		// is the character on the ground?
+		if (UpdateCachedFloor(TargetPawn))
 		{
 			// determine if we need to do a height update
 			bZUpdate = FMath::IsNearlyEqual(CurrentZ, CurrentCameraLocation.Z, 25.0f);
 
 		} else {
 
-			// run a trace below the character to determine if we need to do a height update
-			FHitResult OutHit;
-
-			const FVector End = CurrentActorLocation + FVector(0.0f, 0.0f, -1000.0f);
-
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(TargetPawn);
-
 			// only update height if we're not about to hit ground
-			bZUpdate = !GetWorld()->LineTraceSingleByChannel(OutHit, CurrentActorLocation, End, ECC_Visibility, QueryParams);
+			bZUpdate = !IsNearCachedFloor(CurrentActorLocation);
 
 		}
 
@@ -102,4 +119,130 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 
 		OutVT.POV.Location = FMath::VInterpTo(CurrentCameraLocation, TargetCameraLocation, DeltaTime, 2.0f);
 	}
-}
\ No newline at end of file
+}
+
+bool ASideScrollingCameraManager::UpdateCachedFloor(const APawn* TargetPawn)
+{
+	// forget the cached floor if the view target changed
+	if (CachedFloorPawn.Get() != TargetPawn)
+	{
+		CachedFloorPawn = TargetPawn;
+		bHasCachedFloor = false;
+	}
+
+	const UCharacterMovementComponent* Movement = Cast<UCharacterMovementComponent>(TargetPawn->GetMovementComponent());
+
+	// pawns without character movement only report their vertical velocity
+	if (!Movement)
+	{
+		return FMath::IsNearlyZero(TargetPawn->GetVelocity().Z);
+	}
+
+	// the floor result is only kept up to date while walking
+	if (!Movement->IsMovingOnGround())
+	{
+		return false;
+	}
+
+	// cache the floor height computed by the movement component during its own floor check
+	if (Movement->CurrentFloor.IsWalkableFloor())
+	{
+		CachedFloorZ = Movement->CurrentFloor.HitResult.ImpactPoint.Z;
+		bHasCachedFloor = true;
+	}
+
+	return true;
+}
+
+bool ASideScrollingCameraManager::IsNearCachedFloor(const FVector& TargetLocation) const
+{
+	// without a known floor, assume we're not about to land
+	if (!bHasCachedFloor)
+	{
+		return false;
+	}
+
+	// we're near the ground if we're above the last floor and within proximity range
+	const float HeightAboveFloor = TargetLocation.Z - CachedFloorZ;
+
+	return HeightAboveFloor >= 0.0f && HeightAboveFloor <= GroundProximityDistance;
+}
+
+void ASideScrollingCameraManager::AddFramedPawn(APawn* Pawn)
+{
+	FramedPawns.AddUnique(Pawn);
+}
+
+void ASideScrollingCameraManager::RemoveFramedPawn(APawn* Pawn)
+{
+	FramedPawns.RemoveSwap(Pawn);
+}
+
+void ASideScrollingCameraManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// pick up any characters that began play before us. Later ones will register themselves
+	for (TActorIterator<ASideScrollingCharacter> It(GetWorld()); It; ++It)
+	{
+		if (It->HasActorBegunPlay())
+		{
+			AddFramedPawn(*It);
+		}
+	}
+}
+
+int32 ASideScrollingCameraManager::GetFramedBounds(const APawn* TargetPawn, FBox& OutBounds)
+{
+	// always keep the view target in frame
+	OutBounds += TargetPawn->GetActorLocation();
+
+	int32 NumPawns = 1;
+
+	// iterate backwards so we can drop stale pawns in place
+	for (int32 i = FramedPawns.Num() - 1; i >= 0; --i)
+	{
+		const APawn* Pawn = FramedPawns[i].Get();
+
+		if (!Pawn)
+		{
+			FramedPawns.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		// the view target is already in the bounds
+		if (Pawn == TargetPawn)
+		{
+			continue;
+		}
+
+		OutBounds += Pawn->GetActorLocation();
+		++NumPawns;
+	}
+
+	return NumPawns;
+}
+
+float ASideScrollingCameraManager::GetFramingZoom(const FBox& Bounds) const
+{
+	// get the viewport aspect ratio
+	int32 ViewportX = 16;
+	int32 ViewportY = 9;
+
+	if (PCOwner)
+	{
+		PCOwner->GetViewportSize(ViewportX, ViewportY);
+	}
+
+	const float AspectRatio = ViewportY > 0 ? float(ViewportX) / float(ViewportY) : 16.0f / 9.0f;
+
+	// the camera looks down the Y axis, so it needs to fit the X and Z extents
+	const FVector Extent = Bounds.GetExtent();
+	const float HalfFOVTan = FMath::Tan(FMath::DegreesToRadians(CameraFOV * 0.5f));
+
+	const float ZoomX = (Extent.X + FramingMargin) / HalfFOVTan;
+	const float ZoomZ = (Extent.Z + FramingMargin) * AspectRatio / HalfFOVTan;
+
+	// never get closer than the single target zoom
+	return FMath::Clamp(FMath::Max(ZoomX, ZoomZ), CurrentZoom, FMath::Max(CurrentZoom, MaxFramingZoom));
+}
@@ -8,9 +8,11 @@
 
 /**
  *  Simple side scrolling camera with smooth scrolling and horizontal bounds
+ *  Tracks the ground through the target's movement component instead of tracing for it
+ *  Optionally frames all player characters for co-op, zooming out to keep them on screen
  */
 UCLASS()
-class ASideScrollingCameraManager : public APlayerCameraManager
+class NETWORKCOMPULSORY_API ASideScrollingCameraManager : public APlayerCameraManager
 {
 	GENERATED_BODY()
 	
@@ -19,6 +21,17 @@ public:
 	/** Overrides the default camera view target calculation */
 	virtual void UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime) override;
 
+	/** Adds a player pawn to the framed set */
+	void AddFramedPawn(APawn* Pawn);
+
+	/** Removes a player pawn from the framed set */
+	void RemoveFramedPawn(APawn* Pawn);
+
+protected:
+
+	/** Seeds the framed set with the player characters that already exist */
+	virtual void BeginPlay() override;
+
 public:
 
 	/** How close we want to stay to the view target */
@@ -37,11 +50,55 @@ public:
 	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera", meta=(ClampMin=-100000, ClampMax=100000, Units="cm"))
 	float CameraXMaxBounds = 10000.0f;
 
+	/** Max height above the last known floor at which an airborne target is still considered close to the ground */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera", meta=(ClampMin=0, ClampMax=10000, Units="cm"))
+	float GroundProximityDistance = 1000.0f;
+
+	/** Camera field of view */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera", meta=(ClampMin=5, ClampMax=170, Units="deg"))
+	float CameraFOV = 65.0f;
+
+	/** If true, the camera will frame all player characters instead of only the view target */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera|Co-op")
+	bool bFrameAllPlayers = true;
+
+	/** Extra space to keep around the framed players on every side */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera|Co-op", meta=(ClampMin=0, ClampMax=5000, Units="cm"))
+	float FramingMargin = 300.0f;
+
+	/** Max distance the camera can zoom out to while framing players */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling Camera|Co-op", meta=(ClampMin=0, ClampMax=50000, Units="cm"))
+	float MaxFramingZoom = 3000.0f;
+
 protected:
 
 	/** Last cached camera vertical location. The camera only adjusts its height if necessary. */
 	float CurrentZ = 0.0f;
 
+	/** Height of the last walkable floor the target stood on, read from its movement component */
+	float CachedFloorZ = 0.0f;
+
+	/** Pawn the cached floor height belongs to */
+	TWeakObjectPtr<const APawn> CachedFloorPawn;
+
+	/** If true, the cached floor height is valid for the current target */
+	bool bHasCachedFloor = false;
+
 	/** First-time update camera setup flag */
 	bool bSetup = true;
+
+	/** Player pawns framed by the camera. Updated as characters begin and end play */
+	TArray<TWeakObjectPtr<APawn>> FramedPawns;
+
+	/** Computes the bounds of the view target and all visible framed pawns. Returns the number of pawns in the bounds */
+	int32 GetFramedBounds(const APawn* TargetPawn, FBox& OutBounds);
+
+	/** Returns the camera distance needed to fit the provided bounds in the viewport */
+	float GetFramingZoom(const FBox& Bounds) const;
+
+	/** Updates the cached floor height from the target's movement state. Returns true if the target is on the ground */
+	bool UpdateCachedFloor(const APawn* TargetPawn);
+
+	/** Returns true if the target is airborne but still close above the last floor it stood on */
+	bool IsNearCachedFloor(const FVector& TargetLocation) const;
 };
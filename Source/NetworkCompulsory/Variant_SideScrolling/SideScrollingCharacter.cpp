@@ -2,7 +2,7 @@
 
 
 #include "SideScrollingCharacter.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "SideScrollingCharacterMovementComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Components/InputComponent.h"
@@ -12,9 +12,13 @@
 #include "Engine/World.h"
 #include "SideScrollingInteractable.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "TimerManager.h"
+#include "GameplayTimerSubsystem.h"
+#include "SideScrollingPlayerController.h"
+#include "SideScrollingCameraManager.h"
+#include "NetworkCompulsory.h"
 
-ASideScrollingCharacter::ASideScrollingCharacter()
+ASideScrollingCharacter::ASideScrollingCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USideScrollingCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -59,12 +63,26 @@ ASideScrollingCharacter::ASideScrollingCharacter()
 	JumpMaxCount = 3;
 }
 
+void ASideScrollingCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// let the local cameras frame us
+	SetFramedByCameras(true);
+}
+
 void ASideScrollingCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	// stop framing this character
+	SetFramedByCameras(false);
+
 	// clear the wall jump timer
-	GetWorld()->GetTimerManager().ClearTimer(WallJumpTimer);
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(WallJumpTimer);
+	}
 }
 
 void ASideScrollingCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
@@ -133,6 +151,65 @@ void ASideScrollingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMo
 	}
 }
 
+void ASideScrollingCharacter::FellOutOfWorld(const UDamageType& DmgType)
+{
+	// clients wait for the server to move the character back
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// let the Player Controller respawn us in place
+	if (ASideScrollingPlayerController* PC = Cast<ASideScrollingPlayerController>(GetController()))
+	{
+		if (PC->RespawnPawn())
+		{
+			return;
+		}
+	}
+
+	// no spawn point available, so destroy the character and let it be re-created by the Player Controller
+	Super::FellOutOfWorld(DmgType);
+}
+
+void ASideScrollingCharacter::ResetCharacter(const FTransform& SpawnTransform)
+{
+	// only the server can move the character back
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// clear the wall jump timer
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		Timers->ClearTimer(WallJumpTimer);
+	}
+
+	// reset the advanced jump state
+	bHasWallJumped = false;
+	bHasDoubleJumped = false;
+
+	ResetJumpState();
+
+	// collide with any soft platforms we were passing through
+	if (USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		Movement->ClearPassThroughPlatforms();
+	}
+
+	// move the character to the respawn transform and let it fall onto the floor
+	GetCharacterMovement()->StopMovementImmediately();
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Falling);
+
+	// face the respawn direction
+	if (Controller)
+	{
+		Controller->ClientSetRotation(SpawnTransform.Rotator(), true);
+	}
+}
+
 void ASideScrollingCharacter::Move(const FInputActionValue& Value)
 {
 	FVector2D MoveVector = Value.Get<FVector2D>();
@@ -188,6 +265,13 @@ void ASideScrollingCharacter::DoJumpEnd()
 
 void ASideScrollingCharacter::DoInteract()
 {
+	// interactions are processed by the server
+	if (!HasAuthority())
+	{
+		ServerInteract();
+		return;
+	}
+
 	// do a sphere trace to look for interactive objects
 	FHitResult OutHit;
 
@@ -215,12 +299,29 @@ void ASideScrollingCharacter::DoInteract()
 	}
 }
 
+void ASideScrollingCharacter::ServerInteract_Implementation()
+{
+	DoInteract();
+}
+
 void ASideScrollingCharacter::MultiJump()
 {
+	NC_SCOPE_CYCLE_COUNTER(STAT_NC_MultiJump);
+
+	USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement());
+
 	// does the user want to drop to a lower platform?
 	if (DropValue > 0.0f)
 	{
-		CheckForSoftCollision();
+		// reset the drop value
+		DropValue = 0.0f;
+
+		// let the movement component drop through the soft platform we're standing on
+		if (Movement)
+		{
+			Movement->RequestDrop();
+		}
+
 		return;
 	}
 
@@ -237,42 +338,20 @@ void ASideScrollingCharacter::MultiJump()
 	// if we have a horizontal input, try for wall jump first
 	if (!bHasWallJumped && !FMath::IsNearlyZero(ActionValueY))
 	{
-		// trace ahead of the character for walls
-		FHitResult OutHit;
-
-		const FVector Start = GetActorLocation();
-		const FVector End = Start + (FVector(ActionValueY > 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f) * WallJumpTraceDistance);
-
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
+		FVector WallNormal;
 
-		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
-
-		if (OutHit.bBlockingHit)
+		if (FindWallJumpNormal(ActionValueY, WallNormal))
 		{
-			// rotate to the bounce direction
-			const FRotator BounceRot = UKismetMathLibrary::MakeRotFromX(OutHit.ImpactNormal);
-			SetActorRotation(FRotator(0.0f, BounceRot.Yaw, 0.0f));
-
-			// calculate the impulse vector
-			FVector WallJumpImpulse = OutHit.ImpactNormal * WallJumpHorizontalImpulse;
-			WallJumpImpulse.Z = GetCharacterMovement()->JumpZVelocity * WallJumpVerticalMultiplier;
-
-			// launch the character away from the wall
-			LaunchCharacter(WallJumpImpulse, true, true);
-
-			// enable wall jump lockout for a bit
-			bHasWallJumped = true;
-
-			// schedule wall jump lockout reset
-			GetWorld()->GetTimerManager().SetTimer(WallJumpTimer, this, &ASideScrollingCharacter::ResetWallJump, DelayBetweenWallJumps, false);
+			// let the movement component perform the wall jump so the server replays it on the same move
+			if (Movement)
+			{
+				Movement->bWantsToWallJump = true;
+			}
 
 			return;
 		}
 	}
 
-
-
 	// test for double jump only if we haven't already tested for wall jump
 	if (!bHasWallJumped)
 	{
@@ -290,8 +369,11 @@ void ASideScrollingCharacter::MultiJump()
 			// The movement component handles double jump but we still need to manage the flag for animation
 			if (!bHasDoubleJumped)
 			{
-				// raise the double jump flag
-				bHasDoubleJumped = true;
+				// flag the double jump on the saved move
+				if (Movement)
+				{
+					Movement->bWantsToDoubleJump = true;
+				}
 
 				// let the CMC handle jump
 				Jump();
@@ -300,43 +382,121 @@ void ASideScrollingCharacter::MultiJump()
 	}
 }
 
-void ASideScrollingCharacter::CheckForSoftCollision()
+bool ASideScrollingCharacter::FindWallJumpNormal(float Direction, FVector& OutNormal) const
 {
-	// reset the drop value
-	DropValue = 0.0f;
+	// look up the wall contact cached by the movement component
+	const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement());
 
-	// trace down 
-	FHitResult OutHit;
+	// the wall must be on the side we're moving towards
+	if (Movement && Movement->GetWallContact(OutNormal) && OutNormal.X * Direction < 0.0f)
+	{
+		return true;
+	}
 
+	// we haven't run into a wall on that side recently, so trace ahead of the character for one
 	const FVector Start = GetActorLocation();
-	const FVector End = Start + (FVector::DownVector * SoftCollisionTraceDistance);
-
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(SoftCollisionObjectType);
+	const FVector End = Start + (FVector(Direction > 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f) * WallJumpTraceDistance);
 
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
-	GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, QueryParams);
+	FHitResult OutHit;
+
+	if (!GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams))
+	{
+		return false;
+	}
+
+	OutNormal = OutHit.ImpactNormal;
+	return true;
+}
+
+void ASideScrollingCharacter::PerformWallJump(float Direction)
+{
+	// ignore the request if we've already wall jumped or don't know which way to jump
+	if (bHasWallJumped || FMath::IsNearlyZero(Direction))
+	{
+		return;
+	}
+
+	// make sure we've touched the wall on this machine too
+	FVector WallNormal;
 
-	// did we hit a soft floor?
-	if (OutHit.GetActor())
+	if (!FindWallJumpNormal(Direction, WallNormal))
 	{
-		// drop through the floor
-		SetSoftCollision(true);
+		return;
+	}
+
+	// rotate to the bounce direction
+	const FRotator BounceRot = UKismetMathLibrary::MakeRotFromX(WallNormal);
+	SetActorRotation(FRotator(0.0f, BounceRot.Yaw, 0.0f));
+
+	// calculate the impulse vector
+	FVector WallJumpImpulse = WallNormal * WallJumpHorizontalImpulse;
+	WallJumpImpulse.Z = GetCharacterMovement()->JumpZVelocity * WallJumpVerticalMultiplier;
+
+	// launch the character away from the wall
+	LaunchCharacter(WallJumpImpulse, true, true);
+
+	// enable wall jump lockout for a bit
+	bHasWallJumped = true;
+
+	// schedule wall jump lockout reset. Replayed moves keep the reset scheduled by the original wall jump
+	if (UGameplayTimerSubsystem* Timers = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>())
+	{
+		if (!Timers->IsTimerActive(WallJumpTimer))
+		{
+			Timers->SetTimer(WallJumpTimer, this, &ASideScrollingCharacter::ResetWallJump, DelayBetweenWallJumps);
+		}
 	}
 }
 
+void ASideScrollingCharacter::PerformDoubleJump()
+{
+	// raise the double jump flag. The jump itself is handled by the CMC
+	bHasDoubleJumped = true;
+}
+
+void ASideScrollingCharacter::GetJumpState(bool& bOutHasWallJumped, bool& bOutHasDoubleJumped) const
+{
+	bOutHasWallJumped = bHasWallJumped;
+	bOutHasDoubleJumped = bHasDoubleJumped;
+}
+
+void ASideScrollingCharacter::RestoreJumpState(bool bInHasWallJumped, bool bInHasDoubleJumped)
+{
+	bHasWallJumped = bInHasWallJumped;
+	bHasDoubleJumped = bInHasDoubleJumped;
+}
+
 void ASideScrollingCharacter::ResetWallJump()
 {
 	// reset the wall jump flag
 	bHasWallJumped = false;
 }
 
-void ASideScrollingCharacter::SetSoftCollision(bool bEnabled)
+void ASideScrollingCharacter::SetFramedByCameras(bool bFramed)
 {
-	// enable or disable collision response to the soft collision channel
-	GetCapsuleComponent()->SetCollisionResponseToChannel(SoftCollisionObjectType, bEnabled ? ECR_Ignore : ECR_Block);
+	// only local player controllers have camera managers
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+
+		if (PC && PC->IsLocalController())
+		{
+			if (ASideScrollingCameraManager* CameraManager = Cast<ASideScrollingCameraManager>(PC->PlayerCameraManager))
+			{
+				if (bFramed)
+				{
+					CameraManager->AddFramedPawn(this);
+
+				} else {
+
+					CameraManager->RemoveFramedPawn(this);
+				}
+			}
+		}
+	}
 }
 
 bool ASideScrollingCharacter::HasDoubleJumped() const
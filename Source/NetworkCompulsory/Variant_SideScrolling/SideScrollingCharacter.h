@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "GameplayTimerSubsystem.h"
 #include "SideScrollingCharacter.generated.h"
 
 class UCameraComponent;
@@ -12,6 +13,7 @@ struct FInputActionValue;
 
 /**
  *  A player-controllable character side scrolling game
+ *  Uses a custom movement component to jump and drop through soft platforms
  */
 UCLASS(abstract)
 class ASideScrollingCharacter : public ACharacter
@@ -52,7 +54,7 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Side Scrolling|Wall Jump")
 	float DelayBetweenWallJumps = 0.3f;
 
-	/** Distance to trace ahead of the character for wall jumps */
+	/** Distance to trace ahead of the character for wall jumps, when we haven't run into a wall recently */
 	UPROPERTY(EditAnywhere, Category="Side Scrolling|Wall Jump")
 	float WallJumpTraceDistance = 50.0f;
 
@@ -64,14 +66,6 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Side Scrolling|Wall Jump")
 	float WallJumpVerticalMultiplier = 1.4f;
 
-	/** Collision object type to use for soft collision traces (dropping down floors) */
-	UPROPERTY(EditAnywhere, Category="Side Scrolling|Soft Platforms")
-	TEnumAsByte<ECollisionChannel> SoftCollisionObjectType;
-
-	/** Distance to trace down during soft collision checks */
-	UPROPERTY(EditAnywhere, Category="Side Scrolling|Soft Platforms")
-	float SoftCollisionTraceDistance = 1000.0f;
-
 	/** Last recorded time when this character started falling */
 	float LastFallTime = 0.0f;
 
@@ -80,7 +74,7 @@ protected:
 	float MaxCoyoteTime = 0.16f;
 
 	/** Wall jump lockout timer */
-	FTimerHandle WallJumpTimer;
+	FGameplayTimerHandle WallJumpTimer;
 
 	/** Last captured horizontal movement input value */
 	float ActionValueY = 0.0f;
@@ -100,10 +94,13 @@ protected:
 public:
 	
 	/** Constructor */
-	ASideScrollingCharacter();
+	ASideScrollingCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Gameplay cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -119,6 +116,14 @@ protected:
 	/** Handle movement mode changes to keep track of coyote time jumps */
 	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
+public:
+
+	/** Respawns the character in place instead of destroying it when it falls out of the world */
+	virtual void FellOutOfWorld(const class UDamageType& DmgType) override;
+
+	/** Resets the movement state and moves the character to the provided transform without re-creating it. Server only */
+	void ResetCharacter(const FTransform& SpawnTransform);
+
 protected:
 
 	/** Called for movement input */
@@ -154,19 +159,35 @@ public:
 
 protected:
 
+	/** Runs the interaction on the server, so interactables only change state with authority */
+	UFUNCTION(Server, Reliable)
+	void ServerInteract();
+
 	/** Handles advanced jump logic */
 	void MultiJump();
 
-	/** Checks for soft collision with platforms */
-	void CheckForSoftCollision();
+	/** Looks up a wall we've recently run into along the provided side scrolling direction, or traces for one. Returns true if one was found */
+	bool FindWallJumpNormal(float Direction, FVector& OutNormal) const;
 
 	/** Resets wall jump lockout. Called from timer after a wall jump */
 	void ResetWallJump();
 
+	/** Adds or removes this character from the co-op framing of all local side scrolling cameras */
+	void SetFramedByCameras(bool bFramed);
+
 public:
 
-	/** Sets the soft collision response. True passes, False blocks */
-	void SetSoftCollision(bool bEnabled);
+	/** Performs a wall jump along the provided direction if we've recently run into a wall. Called from the movement component on both the owning client and the server, and again when the client replays moves */
+	void PerformWallJump(float Direction);
+
+	/** Updates the double jump state. Called from the movement component on both the owning client and the server, and again when the client replays moves */
+	void PerformDoubleJump();
+
+	/** Passes back the advanced jump lockout flags, so they can be saved with each move */
+	void GetJumpState(bool& bOutHasWallJumped, bool& bOutHasDoubleJumped) const;
+
+	/** Restores the advanced jump lockout flags saved with a move before it's replayed */
+	void RestoreJumpState(bool bInHasWallJumped, bool bInHasDoubleJumped);
 
 public:
 
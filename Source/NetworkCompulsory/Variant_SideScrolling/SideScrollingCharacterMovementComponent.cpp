@@ -0,0 +1,270 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingCharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "SideScrollingSoftPlatform.h"
+#include "SideScrollingCharacter.h"
+
+void USideScrollingCharacterMovementComponent::RequestDrop()
+{
+	bWantsToDrop = true;
+}
+
+void USideScrollingCharacterMovementComponent::ClearPassThroughPlatforms()
+{
+	// stop ignoring every platform we're passing through
+	for (const FSideScrollingPassThroughPlatform& Entry : PassThroughPlatforms)
+	{
+		if (AActor* Platform = Entry.Platform.Get())
+		{
+			UpdatedPrimitive->IgnoreActorWhenMoving(Platform, false);
+		}
+	}
+
+	PassThroughPlatforms.Reset();
+	bWantsToDrop = false;
+	bWantsToDoubleJump = false;
+	bWantsToWallJump = false;
+}
+
+bool USideScrollingCharacterMovementComponent::IsSoftPlatform(const AActor* Actor)
+{
+	return Actor && Actor->IsA<ASideScrollingSoftPlatform>();
+}
+
+void USideScrollingCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToDrop = (Flags & FSavedMove_SideScrolling::FLAG_Drop) != 0;
+	bWantsToDoubleJump = (Flags & FSavedMove_SideScrolling::FLAG_DoubleJump) != 0;
+	bWantsToWallJump = (Flags & FSavedMove_SideScrolling::FLAG_WallJump) != 0;
+}
+
+FNetworkPredictionData_Client* USideScrollingCharacterMovementComponent::GetPredictionData_Client() const
+{
+	// lazily create the prediction data the same way the base class does
+	if (!ClientPredictionData)
+	{
+		USideScrollingCharacterMovementComponent* MutableThis = const_cast<USideScrollingCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_SideScrolling(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void USideScrollingCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// requests are consumed by a single move
+	const bool bDrop = bWantsToDrop;
+	const bool bDoubleJump = bWantsToDoubleJump;
+	const bool bWallJump = bWantsToWallJump;
+
+	bWantsToDrop = bWantsToDoubleJump = bWantsToWallJump = false;
+
+	// are we standing on a soft platform?
+	if (bDrop && IsMovingOnGround() && CurrentFloor.IsWalkableFloor() && IsSoftPlatform(CurrentFloor.HitResult.GetActor()))
+	{
+		// ignore the platform and let gravity take us down
+		AddPassThroughPlatform(CurrentFloor.HitResult.GetActor());
+		SetMovementMode(MOVE_Falling);
+	}
+
+	ASideScrollingCharacter* SideScrollingCharacter = Cast<ASideScrollingCharacter>(CharacterOwner);
+
+	if (!SideScrollingCharacter)
+	{
+		return;
+	}
+
+	// the character applies the advanced jump. Any launch it requests is handled later in this same move
+	if (bWallJump)
+	{
+		// wall jumps go the way we're accelerating, which is replicated with the move
+		SideScrollingCharacter->PerformWallJump(Acceleration.X);
+	}
+
+	if (bDoubleJump)
+	{
+		SideScrollingCharacter->PerformDoubleJump();
+	}
+}
+
+void USideScrollingCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	if (PassThroughPlatforms.IsEmpty())
+	{
+		return;
+	}
+
+	const FBox CapsuleBounds = UpdatedComponent->Bounds.GetBox();
+
+	for (int32 i = PassThroughPlatforms.Num() - 1; i >= 0; --i)
+	{
+		const FSideScrollingPassThroughPlatform& Entry = PassThroughPlatforms[i];
+		AActor* Platform = Entry.Platform.Get();
+
+		// keep ignoring the platform while the capsule is still inside it
+		if (Platform && CapsuleBounds.Intersect(Entry.Bounds))
+		{
+			continue;
+		}
+
+		// we're clear of the platform, so collide with it again
+		if (Platform)
+		{
+			UpdatedPrimitive->IgnoreActorWhenMoving(Platform, false);
+		}
+
+		PassThroughPlatforms.RemoveAtSwap(i);
+	}
+}
+
+bool USideScrollingCharacterMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	FHitResult Hit(1.0f);
+	bool bMoved = Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, &Hit, Teleport);
+
+	// did we get blocked by a soft platform we should pass through?
+	if (bSweep && Hit.bBlockingHit && ShouldPassThrough(Hit, Delta))
+	{
+		AddPassThroughPlatform(Hit.GetActor());
+
+		// finish the rest of the move now that the platform is ignored
+		bMoved = Super::MoveUpdatedComponentImpl(Delta * (1.0f - Hit.Time), NewRotation, bSweep, &Hit, Teleport);
+	}
+
+	if (OutHit)
+	{
+		*OutHit = Hit;
+	}
+
+	return bMoved;
+}
+
+bool USideScrollingCharacterMovementComponent::ShouldPassThrough(const FHitResult& Hit, const FVector& Delta) const
+{
+	if (!IsSoftPlatform(Hit.GetActor()))
+	{
+		return false;
+	}
+
+	// always pass through when moving upward or when we started inside the platform
+	if (Delta.Z > 0.0f || Hit.bStartPenetrating)
+	{
+		return true;
+	}
+
+	// only land on the platform if it's below the lower hemisphere of the capsule
+	const float LowerHemisphereZ = Hit.Location.Z - CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+	return Hit.ImpactPoint.Z >= LowerHemisphereZ;
+}
+
+void USideScrollingCharacterMovementComponent::AddPassThroughPlatform(AActor* Platform)
+{
+	// skip platforms we're already passing through
+	if (PassThroughPlatforms.ContainsByPredicate([Platform](const FSideScrollingPassThroughPlatform& Entry) { return Entry.Platform == Platform; }))
+	{
+		return;
+	}
+
+	// ignore the whole platform actor in our sweeps. This only affects this pawn's queries
+	UpdatedPrimitive->IgnoreActorWhenMoving(Platform, true);
+
+	// save the platform bounds so we know when we've moved through it
+	FSideScrollingPassThroughPlatform& Entry = PassThroughPlatforms.AddDefaulted_GetRef();
+	Entry.Platform = Platform;
+	Entry.Bounds = Platform->GetComponentsBoundingBox().ExpandBy(FVector(0.0f, 0.0f, PassThroughTolerance));
+}
+
+void FSavedMove_SideScrolling::Clear()
+{
+	Super::Clear();
+
+	bWantsToDrop = false;
+	bWantsToDoubleJump = false;
+	bWantsToWallJump = false;
+
+	bSavedHasWallJumped = false;
+	bSavedHasDoubleJumped = false;
+}
+
+uint8 FSavedMove_SideScrolling::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bWantsToDrop)
+	{
+		Result |= FLAG_Drop;
+	}
+
+	if (bWantsToDoubleJump)
+	{
+		Result |= FLAG_DoubleJump;
+	}
+
+	if (bWantsToWallJump)
+	{
+		Result |= FLAG_WallJump;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_SideScrolling::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_SideScrolling* SideScrollingMove = static_cast<const FSavedMove_SideScrolling*>(NewMove.Get());
+
+	if (bWantsToDrop != SideScrollingMove->bWantsToDrop || bWantsToDoubleJump != SideScrollingMove->bWantsToDoubleJump || bWantsToWallJump != SideScrollingMove->bWantsToWallJump)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_SideScrolling::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		bWantsToDrop = Movement->bWantsToDrop;
+		bWantsToDoubleJump = Movement->bWantsToDoubleJump;
+		bWantsToWallJump = Movement->bWantsToWallJump;
+	}
+
+	// save the advanced jump lockouts at the start of the move
+	if (const ASideScrollingCharacter* SideScrollingCharacter = Cast<ASideScrollingCharacter>(C))
+	{
+		SideScrollingCharacter->GetJumpState(bSavedHasWallJumped, bSavedHasDoubleJumped);
+	}
+}
+
+void FSavedMove_SideScrolling::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// rewind the advanced jump lockouts before the move is replayed
+	if (ASideScrollingCharacter* SideScrollingCharacter = Cast<ASideScrollingCharacter>(C))
+	{
+		SideScrollingCharacter->RestoreJumpState(bSavedHasWallJumped, bSavedHasDoubleJumped);
+	}
+}
+
+FNetworkPredictionData_Client_SideScrolling::FNetworkPredictionData_Client_SideScrolling(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_SideScrolling::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_SideScrolling());
+}
@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WallContactMovementComponent.h"
+#include "SideScrollingCharacterMovementComponent.generated.h"
+
+/**
+ *  Soft platform currently ignored by a side scrolling character's movement sweeps
+ */
+struct FSideScrollingPassThroughPlatform
+{
+	/** Ignored platform actor */
+	TWeakObjectPtr<AActor> Platform;
+
+	/** World bounds of the platform, captured when we started passing through it */
+	FBox Bounds;
+};
+
+/**
+ *  Character Movement Component for the side scrolling character
+ *  Handles one-way soft platforms as part of the movement and floor logic:
+ *  a soft platform is ignored by this pawn's sweeps while moving upward through it or dropping down from it,
+ *  so the capsule's collision responses never change and platforms don't need overlap volumes
+ *  Drops, double jumps and wall jumps are requested through saved move flags, so they're predicted by the owning client and replayed by the server
+ *  Wall contacts, wall slides and correction counting are shared through UWallContactMovementComponent
+ */
+UCLASS()
+class USideScrollingCharacterMovementComponent : public UWallContactMovementComponent
+{
+	GENERATED_BODY()
+
+	/** Soft platforms we're currently passing through */
+	TArray<FSideScrollingPassThroughPlatform> PassThroughPlatforms;
+
+protected:
+
+	/** Extra vertical margin added to platform bounds before we consider we've left them. Covers the floor distance the capsule hovers at */
+	UPROPERTY(EditAnywhere, Category="Character Movement: Soft Platforms", meta = (ClampMin = 0, ClampMax = 50, Units = "cm"))
+	float PassThroughTolerance = 5.0f;
+
+public:
+
+	/** If true, the character will drop through the soft platform it's standing on during the next movement update */
+	bool bWantsToDrop = false;
+
+	/** If true, the character will double jump during the next movement update */
+	bool bWantsToDoubleJump = false;
+
+	/** If true, the character will try to wall jump during the next movement update */
+	bool bWantsToWallJump = false;
+
+public:
+
+	/** Requests a drop through the soft platform we're standing on */
+	void RequestDrop();
+
+	/** Stops ignoring all soft platforms. Used when the character is reset */
+	void ClearPassThroughPlatforms();
+
+	/** Returns true if the provided actor is a one-way soft platform */
+	static bool IsSoftPlatform(const AActor* Actor);
+
+	/** Unpacks the drop and advanced jump requests from the saved move flags */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	/** Returns the client prediction data that saves the drop and advanced jump requests on each move */
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+
+	/** Processes drop and advanced jump requests before the move is performed */
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	/** Stops ignoring the soft platforms we've fully moved through */
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+
+	/** Lets the capsule move through soft platforms it hits from below, from the side or while dropping */
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = nullptr, ETeleportType Teleport = ETeleportType::None) override;
+
+	/** Returns true if the provided blocking hit is against a soft platform we should pass through */
+	bool ShouldPassThrough(const FHitResult& Hit, const FVector& Delta) const;
+
+	/** Starts ignoring the provided soft platform in our movement sweeps */
+	void AddPassThroughPlatform(AActor* Platform);
+};
+
+/**
+ *  Saved move for the side scrolling character
+ *  Carries the drop and advanced jump requests so the server replays them on the same move as the client,
+ *  and the advanced jump lockouts so the client gates them the same way when it replays the move
+ */
+class FSavedMove_SideScrolling : public FSavedMove_Character
+{
+	using Super = FSavedMove_Character;
+
+public:
+
+	/** Compressed flags used by each request */
+	static constexpr uint8 FLAG_Drop = FLAG_Custom_0;
+	static constexpr uint8 FLAG_DoubleJump = FLAG_Custom_1;
+	static constexpr uint8 FLAG_WallJump = FLAG_Custom_2;
+
+	/** Requests captured for this move */
+	bool bWantsToDrop = false;
+	bool bWantsToDoubleJump = false;
+	bool bWantsToWallJump = false;
+
+	/** Advanced jump lockouts at the start of this move, restored before it's replayed */
+	bool bSavedHasWallJumped = false;
+	bool bSavedHasDoubleJumped = false;
+
+	/** Resets the move state */
+	virtual void Clear() override;
+
+	/** Packs the requests into the move flags */
+	virtual uint8 GetCompressedFlags() const override;
+
+	/** Moves with different requests can't be combined */
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	/** Captures the requests from the movement component and the advanced jump lockouts from the character */
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+
+	/** Restores the advanced jump lockouts before the move is replayed */
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+/**
+ *  Client prediction data for the side scrolling character
+ *  Allocates side scrolling saved moves
+ */
+class FNetworkPredictionData_Client_SideScrolling : public FNetworkPredictionData_Client_Character
+{
+	using Super = FNetworkPredictionData_Client_Character;
+
+public:
+
+	/** Constructor */
+	FNetworkPredictionData_Client_SideScrolling(const UCharacterMovementComponent& ClientMovement);
+
+	/** Allocates a side scrolling saved move */
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
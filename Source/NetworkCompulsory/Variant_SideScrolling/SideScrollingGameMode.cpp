@@ -2,34 +2,41 @@
 
 
 #include "SideScrollingGameMode.h"
-#include "Kismet/GameplayStatics.h"
-#include "Blueprint/UserWidget.h"
-#include "SideScrollingUI.h"
-#include "SideScrollingPickup.h"
+#include "SideScrollingGameState.h"
+#include "SideScrollingPlayerState.h"
+#include "GameFramework/Controller.h"
+#include "ReplaySpectatorPlayerController.h"
+#include "SideScrollingPickupSubsystem.h"
 
-void ASideScrollingGameMode::BeginPlay()
+ASideScrollingGameMode::ASideScrollingGameMode()
 {
-	Super::BeginPlay();
+	// replicate pickup state and per-player pickup counts
+	GameStateClass = ASideScrollingGameState::StaticClass();
+	PlayerStateClass = ASideScrollingPlayerState::StaticClass();
 
-	// create the game UI
-	APlayerController* OwningPlayer = UGameplayStatics::GetPlayerController(GetWorld(), 0);
-	
-	UserInterface = CreateWidget<USideScrollingUI>(OwningPlayer, UserInterfaceClass);
+	// keep players connected when the server changes maps
+	bUseSeamlessTravel = true;
 
-	check(UserInterface);
+	// spectate recorded matches with the scrubbing replay controller
+	ReplaySpectatorPlayerControllerClass = AReplaySpectatorPlayerController::StaticClass();
 }
 
-void ASideScrollingGameMode::ProcessPickup()
+void ASideScrollingGameMode::ProcessPickup(AController* Collector)
 {
-	// increment the pickups counter
-	++PickupsCollected;
-
-	// if this is the first pickup we collect, show the UI
-	if (PickupsCollected == 1)
+	// add the pickup to the player's count. The player state replicates it to the owning player's UI
+	if (ASideScrollingPlayerState* PS = Collector ? Collector->GetPlayerState<ASideScrollingPlayerState>() : nullptr)
 	{
-		UserInterface->AddToViewport(0);
+		PS->AddPickups(1);
 	}
+}
+
+void ASideScrollingGameMode::ResetLevel()
+{
+	Super::ResetLevel();
 
-	// update the pickups counter on the UI
-	UserInterface->UpdatePickups(PickupsCollected);
-}
\ No newline at end of file
+	// recycle the pooled pickups and clear the replicated collected state
+	if (USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>())
+	{
+		Pickups->ResetPickups();
+	}
+}
@@ -7,11 +7,13 @@
 #include "SideScrollingGameMode.generated.h"
 
 class USideScrollingUI;
+class AController;
 
 /**
  *  Simple Side Scrolling Game Mode
- *  Spawns and manages the game UI
- *  Counts pickups collected by the player
+ *  Provides the game UI class to each player
+ *  Awards pickups to the players that collect them
+ *  Restores the collected pickups when the level is reset
  */
 UCLASS(abstract)
 class ASideScrollingGameMode : public AGameModeBase
@@ -20,25 +22,21 @@ class ASideScrollingGameMode : public AGameModeBase
 	
 protected:
 
-	/** Class of UI widget to spawn when the game starts */
+	/** Class of UI widget each player spawns to display their pickups */
 	UPROPERTY(EditAnywhere, Category="UI")
 	TSubclassOf<USideScrollingUI> UserInterfaceClass;
 
-	/** User interface widget for the game */
-	UPROPERTY(BlueprintReadOnly, Category="UI")
-	TObjectPtr<USideScrollingUI> UserInterface;
-
-	/** Number of pickups collected by the player */
-	UPROPERTY(BlueprintReadOnly, Category="Pickups")
-	int32 PickupsCollected = 0;
+public:
 
-protected:
+	/** Constructor */
+	ASideScrollingGameMode();
 
-	/** Initialization */
-	virtual void BeginPlay() override;
+	/** Awards a collected pickup to a player */
+	virtual void ProcessPickup(AController* Collector);
 
-public:
+	/** Resets the level, restoring every collected pickup */
+	virtual void ResetLevel() override;
 
-	/** Receives an interaction event from another actor */
-	virtual void ProcessPickup();
+	/** Returns the class of UI widget to spawn for each player */
+	TSubclassOf<USideScrollingUI> GetUserInterfaceClass() const { return UserInterfaceClass; }
 };
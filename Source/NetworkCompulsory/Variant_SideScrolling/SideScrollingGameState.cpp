@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingGameState.h"
+#include "SideScrollingPickupSubsystem.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+bool ASideScrollingGameState::MarkPickupCollected(FName LevelName, int32 PickupIndex)
+{
+	if (!HasAuthority() || PickupIndex < 0)
+	{
+		return false;
+	}
+
+	// find or add the level entry
+	FSideScrollingPickupLevelState* LevelState = PickupLevels.FindByPredicate([LevelName](const FSideScrollingPickupLevelState& State) { return State.LevelName == LevelName; });
+
+	if (!LevelState)
+	{
+		LevelState = &PickupLevels.AddDefaulted_GetRef();
+		LevelState->LevelName = LevelName;
+	}
+
+	// has the pickup already been collected?
+	if (FSideScrollingPickupLevelState::IsBitSet(LevelState->CollectedBits, PickupIndex))
+	{
+		return false;
+	}
+
+	FSideScrollingPickupLevelState::SetBit(LevelState->CollectedBits, PickupIndex);
+
+	return true;
+}
+
+const TArray<uint32>* ASideScrollingGameState::FindCollectedPickups(FName LevelName) const
+{
+	const FSideScrollingPickupLevelState* LevelState = PickupLevels.FindByPredicate([LevelName](const FSideScrollingPickupLevelState& State) { return State.LevelName == LevelName; });
+
+	return LevelState ? &LevelState->CollectedBits : nullptr;
+}
+
+void ASideScrollingGameState::ClearCollectedPickups()
+{
+	if (HasAuthority())
+	{
+		PickupLevels.Reset();
+	}
+}
+
+void ASideScrollingGameState::OnRep_PickupLevels()
+{
+	// hide or restore the pickups that changed
+	if (USideScrollingPickupSubsystem* Pickups = GetWorld()->GetSubsystem<USideScrollingPickupSubsystem>())
+	{
+		Pickups->ApplyCollectedState();
+	}
+}
+
+void ASideScrollingGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASideScrollingGameState, PickupLevels);
+}
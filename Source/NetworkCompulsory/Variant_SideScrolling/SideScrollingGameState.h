@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "SideScrollingGameState.generated.h"
+
+/**
+ *  Collected pickups for a single level, packed one bit per pickup
+ */
+USTRUCT()
+struct FSideScrollingPickupLevelState
+{
+	GENERATED_BODY()
+
+	/** Network stable name of the level that owns the pickups */
+	UPROPERTY()
+	FName LevelName;
+
+	/** One bit per indexed pickup. Set bits have been collected */
+	UPROPERTY()
+	TArray<uint32> CollectedBits;
+
+	/** Returns true if the bit for the provided index is set */
+	static bool IsBitSet(const TArray<uint32>& Bits, int32 Index)
+	{
+		const int32 Word = Index / 32;
+		return Bits.IsValidIndex(Word) && (Bits[Word] & (1u << (Index % 32))) != 0;
+	}
+
+	/** Sets the bit for the provided index, growing the bitfield if needed */
+	static void SetBit(TArray<uint32>& Bits, int32 Index)
+	{
+		const int32 Word = Index / 32;
+
+		if (Word >= Bits.Num())
+		{
+			Bits.AddZeroed(Word + 1 - Bits.Num());
+		}
+
+		Bits[Word] |= 1u << (Index % 32);
+	}
+
+	/** Clears the bit for the provided index */
+	static void ClearBit(TArray<uint32>& Bits, int32 Index)
+	{
+		const int32 Word = Index / 32;
+
+		if (Bits.IsValidIndex(Word))
+		{
+			Bits[Word] &= ~(1u << (Index % 32));
+		}
+	}
+};
+
+/**
+ *  Simple GameState for a side scrolling game
+ *  Replicates the collected state of every pickup as one bitfield per level
+ */
+UCLASS()
+class ASideScrollingGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Collected pickups, per level */
+	UPROPERTY(ReplicatedUsing = OnRep_PickupLevels)
+	TArray<FSideScrollingPickupLevelState> PickupLevels;
+
+public:
+
+	/** Marks a pickup as collected. Returns false if it was already collected. Server only */
+	bool MarkPickupCollected(FName LevelName, int32 PickupIndex);
+
+	/** Returns the collected bitfield for a level, or nullptr if nothing has been collected there */
+	const TArray<uint32>* FindCollectedPickups(FName LevelName) const;
+
+	/** Clears the collected state of all pickups. Server only */
+	void ClearCollectedPickups();
+
+protected:
+
+	/** Passes the replicated pickup state to the pickup subsystem */
+	UFUNCTION()
+	void OnRep_PickupLevels();
+
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+};
@@ -4,13 +4,16 @@
 #include "SideScrollingPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
+#include "PlayerSpawnSubsystem.h"
 #include "SideScrollingCharacter.h"
+#include "SideScrollingGameMode.h"
+#include "SideScrollingUI.h"
+#include "GameFramework/GameStateBase.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
 #include "Blueprint/UserWidget.h"
 #include "NetworkCompulsory.h"
+#include "MemoryBudgetSubsystem.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
 void ASideScrollingPlayerController::BeginPlay()
@@ -21,6 +24,7 @@ void ASideScrollingPlayerController::BeginPlay()
 	if (SVirtualJoystick::ShouldDisplayTouchInterface() && IsLocalPlayerController())
 	{
 		// spawn the mobile controls widget
+		LLM_SCOPE_BYTAG(NCUI);
 		MobileControlsWidget = CreateWidget<UUserWidget>(this, MobileControlsWidgetClass);
 
 		if (MobileControlsWidget)
@@ -70,21 +74,88 @@ void ASideScrollingPlayerController::OnPossess(APawn* InPawn)
 	InPawn->OnDestroyed.AddDynamic(this, &ASideScrollingPlayerController::OnPawnDestroyed);
 }
 
+bool ASideScrollingPlayerController::RespawnPawn()
+{
+	ASideScrollingCharacter* SideScrollingCharacter = Cast<ASideScrollingCharacter>(GetPawn());
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
+
+	if (!SideScrollingCharacter || !Spawns)
+	{
+		return false;
+	}
+
+	// find the best spawn point
+	FTransform SpawnTransform;
+
+	if (!Spawns->FindSpawnTransform(this, SpawnPointPolicy, SideScrollingCharacter->GetActorLocation(), SpawnTransform))
+	{
+		return false;
+	}
+
+	// reuse the existing character instead of spawning a new one
+	SideScrollingCharacter->ResetCharacter(SpawnTransform);
+
+	NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), SideScrollingCharacter);
+
+	return true;
+}
+
+void ASideScrollingPlayerController::UpdatePickupUI(int32 PickupsCollected)
+{
+	// nothing to show until the first pickup is collected
+	if (PickupsCollected <= 0 && !UserInterface)
+	{
+		return;
+	}
+
+	// create the UI on first use. Clients don't have a game mode, so read the class from its defaults
+	if (!UserInterface)
+	{
+		const AGameStateBase* GameState = GetWorld()->GetGameState();
+		const ASideScrollingGameMode* GameModeDefaults = GameState ? GameState->GetDefaultGameMode<ASideScrollingGameMode>() : nullptr;
+
+		if (!GameModeDefaults)
+		{
+			return;
+		}
+
+		LLM_SCOPE_BYTAG(NCUI);
+		UserInterface = CreateWidget<USideScrollingUI>(this, GameModeDefaults->GetUserInterfaceClass());
+
+		if (!UserInterface)
+		{
+			UE_LOG(LogNetworkCompulsory, Error, TEXT("Could not spawn pickup UI widget."));
+			return;
+		}
+
+		UserInterface->AddToPlayerScreen(0);
+	}
+
+	// update the pickups counter on the UI
+	UserInterface->UpdatePickups(PickupsCollected);
+}
+
 void ASideScrollingPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
-	// find the player start
-	TArray<AActor*> ActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
+	UPlayerSpawnSubsystem* Spawns = GetWorld()->GetSubsystem<UPlayerSpawnSubsystem>();
 
-	if (ActorList.Num() > 0)
+	if (!Spawns)
 	{
-		// spawn a character at the player start
-		const FTransform SpawnTransform = ActorList[0]->GetActorTransform();
+		return;
+	}
+
+	// find the best spawn point
+	FTransform SpawnTransform;
 
-		if (ASideScrollingCharacter* RespawnedCharacter = GetWorld()->SpawnActor<ASideScrollingCharacter>(CharacterClass, SpawnTransform))
+	if (Spawns->FindSpawnTransform(this, SpawnPointPolicy, DestroyedActor->GetActorLocation(), SpawnTransform))
+	{
+		// get a character at the spawn point
+		if (ASideScrollingCharacter* RespawnedCharacter = Cast<ASideScrollingCharacter>(Spawns->SpawnPawn(CharacterClass, SpawnTransform)))
 		{
 			// possess the character
 			Possess(RespawnedCharacter);
+
+			NetworkCompulsoryHitch::RecordEvent(TEXT("RespawnPawn"), RespawnedCharacter);
 		}
 	}
 }
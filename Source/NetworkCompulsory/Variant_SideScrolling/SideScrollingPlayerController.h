@@ -5,15 +5,18 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "EnhancedInput/Public/InputAction.h"
+#include "PlayerSpawnSubsystem.h"
 #include "SideScrollingPlayerController.generated.h"
 
 class ASideScrollingCharacter;
 class UInputMappingContext;
+class USideScrollingUI;
 
 /**
  *  A simple Side Scrolling Player Controller
- *  Manages input mappings
- *  Respawns the player pawn at the player start if it is destroyed
+ *  Manages input mappings and the pickup counter UI
+ *  Respawns the player pawn in place when it falls out of the world,
+ *  or at the player start if it is destroyed
  */
 UCLASS(abstract)
 class ASideScrollingPlayerController : public APlayerController
@@ -37,10 +40,18 @@ protected:
 	/** Pointer to the mobile controls widget */
 	TObjectPtr<UUserWidget> MobileControlsWidget;
 
+	/** Pickup counter UI. Created when the first pickup is collected */
+	UPROPERTY()
+	TObjectPtr<USideScrollingUI> UserInterface;
+
 	/** Character class to respawn when the possessed pawn is destroyed */
 	UPROPERTY(EditAnywhere, Category="Respawn")
 	TSubclassOf<ASideScrollingCharacter> CharacterClass;
 
+	/** Policy used to choose the spawn point when respawning */
+	UPROPERTY(EditAnywhere, Category="Respawn")
+	ESpawnPointPolicy SpawnPointPolicy = ESpawnPointPolicy::First;
+
 protected:
 
 	/** Gameplay initialization */
@@ -52,6 +63,16 @@ protected:
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+public:
+
+	/** Resets the possessed character in place at the best spawn point. Returns false if the character couldn't be respawned */
+	bool RespawnPawn();
+
+	/** Updates the pickup counter on the UI, showing it on the first pickup */
+	void UpdatePickupUI(int32 PickupsCollected);
+
+protected:
+
 	/** Called if the possessed pawn is destroyed */
 	UFUNCTION()
 	void OnPawnDestroyed(AActor* DestroyedActor);
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingPlayerState.h"
+#include "SideScrollingPlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+void ASideScrollingPlayerState::AddPickups(int32 Amount)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// update the pickup count and score
+	PickupsCollected += Amount;
+	SetScore(GetScore() + Amount);
+
+	// listen servers don't get a rep notify for their own player
+	UpdatePickupUI();
+}
+
+void ASideScrollingPlayerState::OnRep_PickupsCollected()
+{
+	UpdatePickupUI();
+}
+
+void ASideScrollingPlayerState::UpdatePickupUI()
+{
+	// only the owning player displays their pickup count
+	ASideScrollingPlayerController* PC = Cast<ASideScrollingPlayerController>(GetPlayerController());
+
+	if (PC && PC->IsLocalController())
+	{
+		PC->UpdatePickupUI(PickupsCollected);
+	}
+}
+
+void ASideScrollingPlayerState::CopyProperties(APlayerState* PlayerState)
+{
+	Super::CopyProperties(PlayerState);
+
+	if (ASideScrollingPlayerState* NewPlayerState = Cast<ASideScrollingPlayerState>(PlayerState))
+	{
+		NewPlayerState->PickupsCollected = PickupsCollected;
+	}
+}
+
+void ASideScrollingPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASideScrollingPlayerState, PickupsCollected);
+}
@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "SideScrollingPlayerState.generated.h"
+
+/**
+ *  Simple PlayerState for a side scrolling game
+ *  Replicates the number of pickups collected by each player
+ */
+UCLASS()
+class ASideScrollingPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of pickups collected by this player */
+	UPROPERTY(ReplicatedUsing = OnRep_PickupsCollected, BlueprintReadOnly, Category="Pickups")
+	int32 PickupsCollected = 0;
+
+public:
+
+	/** Adds collected pickups to this player's count and score. Server only */
+	void AddPickups(int32 Amount);
+
+	/** Returns the number of pickups collected by this player */
+	int32 GetPickupsCollected() const { return PickupsCollected; }
+
+protected:
+
+	/** Handles pickup count replication */
+	UFUNCTION()
+	void OnRep_PickupsCollected();
+
+	/** Updates the pickup counter on the owning player's UI, if it's local */
+	void UpdatePickupUI();
+
+	/** Carries the pickup count over to the new player state after seamless travel */
+	virtual void CopyProperties(APlayerState* PlayerState) override;
+
+	/** Property replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+};
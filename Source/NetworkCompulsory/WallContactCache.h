@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+/**
+ *  Short-lived record of the last wall a character ran into during its movement.
+ *  Fed from the movement component's impacts, so wall checks become a lookup instead of a scene query.
+ *  Ages with simulated movement time, so the owning client and the server agree on it for the same move.
+ */
+struct FWallContactCache
+{
+	/** Horizontal normal of the wall, pointing away from it */
+	FVector Normal = FVector::ZeroVector;
+
+	/** Point where we touched the wall */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	/** Movement time since we last touched the wall */
+	float Age = TNumericLimits<float>::Max();
+
+	/** Saves the hit if it's against a wall. Returns true if the contact was recorded */
+	bool RecordHit(const FHitResult& Hit, float MaxWallNormalZ)
+	{
+		// ignore floors and ceilings
+		if (!Hit.bBlockingHit || FMath::Abs(Hit.ImpactNormal.Z) > MaxWallNormalZ)
+		{
+			return false;
+		}
+
+		Normal = Hit.ImpactNormal.GetSafeNormal2D();
+		ImpactPoint = Hit.ImpactPoint;
+		Age = 0.0f;
+
+		return true;
+	}
+
+	/** Ages the contact by the provided movement time */
+	void Advance(float DeltaSeconds)
+	{
+		if (IsSet())
+		{
+			Age += DeltaSeconds;
+		}
+	}
+
+	/** Returns true if we've touched a wall within the provided movement time */
+	bool IsFresh(float MaxAge) const
+	{
+		return Age <= MaxAge;
+	}
+
+	/** Returns true if we've touched a wall since the last reset */
+	bool IsSet() const
+	{
+		return Age < TNumericLimits<float>::Max();
+	}
+
+	/** Forgets the contact */
+	void Reset()
+	{
+		Age = TNumericLimits<float>::Max();
+	}
+};
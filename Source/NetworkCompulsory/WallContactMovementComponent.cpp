@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "WallContactMovementComponent.h"
+#include "NetworkCompulsory.h"
+
+bool UWallContactMovementComponent::GetWallContact(FVector& OutNormal) const
+{
+	if (!WallContact.IsFresh(WallContactMaxAge))
+	{
+		return false;
+	}
+
+	OutNormal = WallContact.Normal;
+	return true;
+}
+
+bool UWallContactMovementComponent::IsWallSliding() const
+{
+	// are we falling down next to a wall?
+	if (!bCanWallSlide || !IsFalling() || Velocity.Z >= 0.0f || !WallContact.IsFresh(WallContactMaxAge))
+	{
+		return false;
+	}
+
+	// only slide while pushing against the wall
+	return FVector::DotProduct(Acceleration, WallContact.Normal) < 0.0f;
+}
+
+void UWallContactMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// age the wall contact by this move's time
+	WallContact.Advance(DeltaSeconds);
+}
+
+void UWallContactMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSlice, const FVector& MoveDelta)
+{
+	Super::HandleImpact(Hit, TimeSlice, MoveDelta);
+
+	// remember the wall so jump checks don't need to look for it
+	WallContact.RecordHit(Hit, MaxWallNormalZ);
+}
+
+FVector UWallContactMovementComponent::NewFallVelocity(const FVector& InitialVelocity, const FVector& Gravity, float DeltaTime) const
+{
+	FVector Result = Super::NewFallVelocity(InitialVelocity, Gravity, DeltaTime);
+
+	// cap the fall speed while sliding down a wall
+	if (IsWallSliding())
+	{
+		Result.Z = FMath::Max(Result.Z, -WallSlideMaxFallSpeed);
+	}
+
+	return Result;
+}
+
+bool UWallContactMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	const bool bError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+	if (bError)
+	{
+		NetworkCompulsoryNet::RecordMovementCorrection();
+	}
+
+	return bError;
+}
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WallContactCache.h"
+#include "WallContactMovementComponent.generated.h"
+
+/**
+ *  Base Character Movement Component for characters that jump off and slide down walls
+ *  Keeps a short-lived cache of wall contacts from movement hits for wall jumps and wall slides
+ *  Also counts the movement corrections the server sends to the owning client
+ */
+UCLASS(Abstract)
+class UWallContactMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Movement time a wall contact stays valid for wall jumps and wall slides */
+	UPROPERTY(EditAnywhere, Category="Character Movement: Walls", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float WallContactMaxAge = 0.1f;
+
+	/** Max absolute Z of a hit normal for it to count as a wall */
+	UPROPERTY(EditAnywhere, Category="Character Movement: Walls", meta = (ClampMin = 0, ClampMax = 1))
+	float MaxWallNormalZ = 0.3f;
+
+	/** If true, the character slides down walls it's pushing against instead of free falling */
+	UPROPERTY(EditAnywhere, Category="Character Movement: Walls")
+	bool bCanWallSlide = false;
+
+	/** Max fall speed while sliding down a wall */
+	UPROPERTY(EditAnywhere, Category="Character Movement: Walls", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm/s", EditCondition = "bCanWallSlide"))
+	float WallSlideMaxFallSpeed = 300.0f;
+
+	/** Last wall we ran into while moving */
+	FWallContactCache WallContact;
+
+public:
+
+	/** Returns true if we've touched a wall recently, and passes back its normal */
+	bool GetWallContact(FVector& OutNormal) const;
+
+	/** Returns true if the character is sliding down a wall */
+	UFUNCTION(BlueprintPure, Category="Character Movement: Walls")
+	bool IsWallSliding() const;
+
+protected:
+
+	/** Ages the wall contact by the move's time */
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	/** Records wall contacts from movement hits */
+	virtual void HandleImpact(const FHitResult& Hit, float TimeSlice = 0.0f, const FVector& MoveDelta = FVector::ZeroVector) override;
+
+	/** Caps the fall speed while sliding down a wall */
+	virtual FVector NewFallVelocity(const FVector& InitialVelocity, const FVector& Gravity, float DeltaTime) const override;
+
+	/** Counts the corrections sent to the owning client */
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+};
@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/SoftObjectPtr.h"
+#include "GameplayBenchmarkSettings.generated.h"
+
+class AActor;
+
+/**
+ *  Settings for the gameplay benchmark automation tests.
+ *  Classes, actor counts and iteration counts are read from DefaultGame.ini
+ */
+UCLASS(config=Game)
+class UGameplayBenchmarkSettings : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Map the benchmarks run in */
+	UPROPERTY(Config)
+	FString Map = TEXT("/Game/Variant_Combat/Lvl_Combat");
+
+	/** Projectile fired by the projectile benchmarks */
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> ProjectileClass;
+
+	/** Character used as the attacker and camera target */
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> AttackerClass;
+
+	/** Damageable actor placed in front of the attacker */
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> DamageableClass;
+
+	/** Enemy spawned by the wave and StateTree benchmarks */
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> EnemyClass;
+
+	/** World location the benchmark actors are spawned around */
+	UPROPERTY(Config)
+	FVector Origin = FVector::ZeroVector;
+
+	/** Actor counts each scaling benchmark runs at */
+	UPROPERTY(Config)
+	TArray<int32> ActorCounts = { 1, 10, 100 };
+
+	/** Number of calls timed by each synchronous benchmark */
+	UPROPERTY(Config)
+	int32 Iterations = 1000;
+
+	/** Frames to let spawned AIs settle before measuring */
+	UPROPERTY(Config)
+	int32 WarmupFrames = 30;
+
+	/** Frames measured by the frame based benchmarks */
+	UPROPERTY(Config)
+	int32 MeasureFrames = 120;
+};
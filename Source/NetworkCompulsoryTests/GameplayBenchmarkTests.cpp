@@ -0,0 +1,727 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "GameplayBenchmarkSettings.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/DamageType.h"
+#include "AIController.h"
+#include "Components/StateTreeAIComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Projectile.h"
+#include "CombatAttacker.h"
+#include "CombatDamageable.h"
+#include "CombatDamageSubsystem.h"
+#include "SideScrollingCameraManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ *  Gameplay micro-benchmarks, run as automation tests inside the configured map.
+ *  Run them from the editor's Session Frontend, or headless with
+ *  UnrealEditor-Cmd NetworkCompulsory.uproject -ExecCmds="Automation RunTests NetworkCompulsory.Benchmarks; Quit" -nullrhi -unattended
+ *  Each test writes its results as JSON to Saved/Benchmarks so they can be tracked across commits
+ */
+namespace NetworkCompulsoryBenchmarks
+{
+	/** Test flags shared by every benchmark */
+	static constexpr EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter;
+
+	/** Returns the game or PIE world opened by the test */
+	static UWorld* GetBenchmarkWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::PIE || Context.WorldType == EWorldType::Game) && Context.World())
+			{
+				return Context.World();
+			}
+		}
+
+		return nullptr;
+	}
+
+	/** Returns the time in milliseconds between two cycle counts */
+	static double CyclesToMs(uint64 StartCycles, uint64 EndCycles)
+	{
+		return FPlatformTime::ToMilliseconds64(EndCycles - StartCycles);
+	}
+
+	/** Spawns an actor of the provided class at an offset from the benchmark origin */
+	static AActor* SpawnBenchmarkActor(UWorld* World, UClass* Class, const FVector& Offset)
+	{
+		if (!Class)
+		{
+			return nullptr;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		return World->SpawnActor<AActor>(Class, FTransform(GetDefault<UGameplayBenchmarkSettings>()->Origin + Offset), SpawnParams);
+	}
+
+	/** Destroys the actors spawned for a benchmark */
+	static void DestroyBenchmarkActors(TArray<TWeakObjectPtr<AActor>>& Actors)
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : Actors)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+
+		Actors.Reset();
+	}
+
+	/** Loads a configured class, adding a test error if it isn't set or can't be loaded */
+	static UClass* LoadBenchmarkClass(FAutomationTestBase* Test, const TSoftClassPtr<AActor>& SoftClass, const TCHAR* Setting)
+	{
+		UClass* Class = SoftClass.LoadSynchronous();
+
+		if (!Class)
+		{
+			Test->AddError(FString::Printf(TEXT("%s is not set or couldn't be loaded. Set it in [/Script/NetworkCompulsoryTests.GameplayBenchmarkSettings]"), Setting));
+		}
+
+		return Class;
+	}
+
+	/**
+	 *  Results of a single benchmark test
+	 */
+	struct FBenchmarkReport
+	{
+		/** A single benchmark measurement */
+		struct FResult
+		{
+			FString Name;
+			int32 Count = 0;
+			int32 Iterations = 0;
+			double TotalMs = 0.0;
+		};
+
+		/** Measurements, in the order they were taken */
+		TArray<FResult> Results;
+
+		/** Adds a measurement and logs it to the test */
+		void Add(FAutomationTestBase* Test, const FString& Name, int32 Count, int32 NumIterations, double TotalMs)
+		{
+			FResult& Result = Results.AddDefaulted_GetRef();
+			Result.Name = Name;
+			Result.Count = Count;
+			Result.Iterations = NumIterations;
+			Result.TotalMs = TotalMs;
+
+			Test->AddInfo(FString::Printf(TEXT("%s (%d): %.3f us per iteration"), *Name, Count, NumIterations > 0 ? TotalMs * 1000.0 / NumIterations : 0.0));
+		}
+
+		/** Writes the measurements to Saved/Benchmarks */
+		void Write(FAutomationTestBase* Test, const FString& BenchmarkName, const UWorld* World) const
+		{
+			FString Json = FString::Printf(TEXT("{\n\"benchmark\":\"%s\",\n\"map\":\"%s\",\n\"config\":\"%s\",\n\"timestamp\":\"%s\",\n\"results\":["),
+				*BenchmarkName, World ? *World->GetMapName() : TEXT(""), LexToString(FApp::GetBuildConfiguration()), *FDateTime::UtcNow().ToIso8601());
+
+			for (int32 Index = 0; Index < Results.Num(); ++Index)
+			{
+				const FResult& Result = Results[Index];
+
+				Json += FString::Printf(TEXT("%s\n{\"name\":\"%s\",\"count\":%d,\"iterations\":%d,\"totalMs\":%.4f,\"perIterationUs\":%.4f}"),
+					Index > 0 ? TEXT(",") : TEXT(""), *Result.Name, Result.Count, Result.Iterations, Result.TotalMs, Result.Iterations > 0 ? Result.TotalMs * 1000.0 / Result.Iterations : 0.0);
+			}
+
+			Json += TEXT("\n]\n}\n");
+
+			const FString Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("Bench-%s-%s.json"), *BenchmarkName, *FDateTime::Now().ToString());
+
+			if (!FFileHelper::SaveStringToFile(Json, *Path))
+			{
+				Test->AddError(FString::Printf(TEXT("Could not write %s"), *Path));
+			}
+		}
+	};
+
+	/**
+	 *  Latent command that runs a benchmark step in the test world every frame until it returns true
+	 */
+	class FBenchmarkStepCommand : public IAutomationLatentCommand
+	{
+	public:
+
+		FBenchmarkStepCommand(FAutomationTestBase* InTest, TFunction<bool(UWorld*)> InStep)
+			: Test(InTest)
+			, Step(MoveTemp(InStep))
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* World = GetBenchmarkWorld();
+
+			if (!World)
+			{
+				Test->AddError(TEXT("No game world to run the benchmark in"));
+				return true;
+			}
+
+			return Step(World);
+		}
+
+	private:
+
+		/** Test the step reports to */
+		FAutomationTestBase* Test;
+
+		/** Step to run. Returns true once it's done */
+		TFunction<bool(UWorld*)> Step;
+	};
+
+	/** Opens the benchmark map and queues a single frame benchmark step that writes its report when done */
+	static void RunSyncBenchmark(FAutomationTestBase* Test, const FString& BenchmarkName, TFunction<void(UWorld*, FBenchmarkReport&)> Benchmark)
+	{
+		AutomationOpenMap(GetDefault<UGameplayBenchmarkSettings>()->Map);
+
+		ADD_LATENT_AUTOMATION_COMMAND(FBenchmarkStepCommand(Test, [Test, BenchmarkName, Benchmark](UWorld* World)
+		{
+			FBenchmarkReport Report;
+			Benchmark(World, Report);
+			Report.Write(Test, BenchmarkName, World);
+
+			return true;
+		}));
+	}
+
+	/**
+	 *  Free list projectile pool, as the firing code would use one.
+	 *  Released projectiles are hidden, stop colliding, ticking and moving, and are moved back into flight when acquired
+	 */
+	class FProjectilePool
+	{
+	public:
+
+		/** Returns an inactive projectile moving from the provided transform, spawning one if the pool is empty */
+		AProjectile* Acquire(UWorld* World, UClass* Class, const FTransform& Transform)
+		{
+			AProjectile* Projectile = nullptr;
+
+			while (!Projectile && FreeProjectiles.Num() > 0)
+			{
+				Projectile = FreeProjectiles.Pop(EAllowShrinking::No).Get();
+			}
+
+			if (!Projectile)
+			{
+				FActorSpawnParameters SpawnParams;
+				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+				Projectile = World->SpawnActor<AProjectile>(Class, Transform, SpawnParams);
+
+				if (Projectile)
+				{
+					AllProjectiles.Add(Projectile);
+				}
+
+				return Projectile;
+			}
+
+			Projectile->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+			Projectile->SetActorEnableCollision(true);
+			Projectile->SetActorHiddenInGame(false);
+			Projectile->SetActorTickEnabled(true);
+
+			if (UProjectileMovementComponent* Movement = Projectile->ProjectileMovementComponent)
+			{
+				Movement->SetUpdatedComponent(Projectile->GetRootComponent());
+				Movement->Velocity = Transform.GetRotation().GetForwardVector() * Movement->InitialSpeed;
+				Movement->Activate(true);
+				Movement->UpdateComponentVelocity();
+			}
+
+			return Projectile;
+		}
+
+		/** Deactivates a projectile and returns it to the free list */
+		void Release(AProjectile* Projectile)
+		{
+			if (!Projectile)
+			{
+				return;
+			}
+
+			if (UProjectileMovementComponent* Movement = Projectile->ProjectileMovementComponent)
+			{
+				Movement->StopMovementImmediately();
+				Movement->Deactivate();
+			}
+
+			Projectile->SetActorTickEnabled(false);
+			Projectile->SetActorEnableCollision(false);
+			Projectile->SetActorHiddenInGame(true);
+
+			FreeProjectiles.Add(Projectile);
+		}
+
+		/** Returns the number of projectiles the pool has spawned */
+		int32 Num() const { return AllProjectiles.Num(); }
+
+		/** Destroys every projectile the pool has spawned */
+		void Empty()
+		{
+			DestroyBenchmarkActors(AllProjectiles);
+			FreeProjectiles.Reset();
+		}
+
+	private:
+
+		/** Every projectile spawned by the pool */
+		TArray<TWeakObjectPtr<AActor>> AllProjectiles;
+
+		/** Projectiles waiting to be acquired */
+		TArray<TWeakObjectPtr<AProjectile>> FreeProjectiles;
+	};
+}
+
+using namespace NetworkCompulsoryBenchmarks;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileBenchmarkTest, "NetworkCompulsory.Benchmarks.Projectiles", TestFlags)
+
+bool FProjectileBenchmarkTest::RunTest(const FString& Parameters)
+{
+	RunSyncBenchmark(this, TEXT("Projectiles"), [this](UWorld* World, FBenchmarkReport& Report)
+	{
+		const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+		UClass* Class = LoadBenchmarkClass(this, Settings->ProjectileClass, TEXT("ProjectileClass"));
+
+		if (!Class || !Class->IsChildOf<AProjectile>())
+		{
+			AddError(TEXT("ProjectileClass must be a projectile"));
+			return;
+		}
+
+		const FTransform MuzzleTransform(Settings->Origin + FVector(0.0f, 0.0f, 200.0f));
+
+		// fire with the given number of projectiles in flight, retiring the oldest one for every shot
+		for (const int32 Count : Settings->ActorCounts)
+		{
+			if (Count < 1)
+			{
+				continue;
+			}
+
+			// spawn a projectile per shot and destroy it when it's retired
+			TArray<TWeakObjectPtr<AActor>> InFlight;
+
+			uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				if (InFlight.Num() >= Count)
+				{
+					if (AActor* Oldest = InFlight[0].Get())
+					{
+						Oldest->Destroy();
+					}
+
+					InFlight.RemoveAt(0, EAllowShrinking::No);
+				}
+
+				InFlight.Add(SpawnBenchmarkActor(World, Class, MuzzleTransform.GetLocation() - Settings->Origin));
+			}
+
+			Report.Add(this, TEXT("ProjectileSpawnDestroy"), Count, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			DestroyBenchmarkActors(InFlight);
+
+			// acquire a projectile per shot from the pool and release it when it's retired
+			FProjectilePool Pool;
+			TArray<AProjectile*> PooledInFlight;
+
+			StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				if (PooledInFlight.Num() >= Count)
+				{
+					Pool.Release(PooledInFlight[0]);
+					PooledInFlight.RemoveAt(0, EAllowShrinking::No);
+				}
+
+				PooledInFlight.Add(Pool.Acquire(World, Class, MuzzleTransform));
+			}
+
+			Report.Add(this, TEXT("ProjectilePool"), Count, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			// the pool only ever needs as many projectiles as are in flight
+			TestEqual(TEXT("Projectiles spawned by the pool"), Pool.Num(), FMath::Min(Count, Settings->Iterations));
+
+			Pool.Empty();
+		}
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAttackTraceBenchmarkTest, "NetworkCompulsory.Benchmarks.AttackTrace", TestFlags)
+
+bool FAttackTraceBenchmarkTest::RunTest(const FString& Parameters)
+{
+	RunSyncBenchmark(this, TEXT("AttackTrace"), [this](UWorld* World, FBenchmarkReport& Report)
+	{
+		const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+
+		UClass* AttackerClass = LoadBenchmarkClass(this, Settings->AttackerClass, TEXT("AttackerClass"));
+		UClass* TargetClass = LoadBenchmarkClass(this, Settings->DamageableClass, TEXT("DamageableClass"));
+
+		AActor* AttackerActor = SpawnBenchmarkActor(World, AttackerClass, FVector::ZeroVector);
+		ICombatAttacker* Attacker = Cast<ICombatAttacker>(AttackerActor);
+
+		if (!Attacker || !TargetClass)
+		{
+			AddError(TEXT("Couldn't spawn a combat attacker"));
+
+			if (AttackerActor)
+			{
+				AttackerActor->Destroy();
+			}
+
+			return;
+		}
+
+		UCombatDamageSubsystem* DamageSubsystem = World->GetSubsystem<UCombatDamageSubsystem>();
+
+		for (const int32 Count : Settings->ActorCounts)
+		{
+			if (Count < 1)
+			{
+				continue;
+			}
+
+			// pack the damageables in front of the attacker
+			TArray<TWeakObjectPtr<AActor>> Targets;
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Targets.Add(SpawnBenchmarkActor(World, TargetClass, FVector(100.0f, (Index % 10) * 10.0f - 45.0f, (Index / 10) * 10.0f)));
+			}
+
+			double TotalMs = 0.0;
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+
+				Attacker->DoAttackTrace(NAME_None);
+
+				TotalMs += CyclesToMs(StartCycles, FPlatformTime::Cycles64());
+
+				// apply the queued damage outside the timed section so it doesn't pile up
+				if (DamageSubsystem)
+				{
+					DamageSubsystem->Tick(0.0f);
+				}
+			}
+
+			Report.Add(this, TEXT("AttackTrace"), Count, Settings->Iterations, TotalMs);
+
+			DestroyBenchmarkActors(Targets);
+		}
+
+		AttackerActor->Destroy();
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraUpdateBenchmarkTest, "NetworkCompulsory.Benchmarks.CameraUpdate", TestFlags)
+
+bool FCameraUpdateBenchmarkTest::RunTest(const FString& Parameters)
+{
+	RunSyncBenchmark(this, TEXT("CameraUpdate"), [this](UWorld* World, FBenchmarkReport& Report)
+	{
+		const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+
+		// the camera reads the viewport through its owning player controller
+		APlayerController* PC = World->GetFirstPlayerController();
+		APlayerController* SpawnedPC = nullptr;
+
+		if (!PC)
+		{
+			PC = SpawnedPC = World->SpawnActor<APlayerController>();
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = PC;
+
+		ASideScrollingCameraManager* CameraManager = PC ? World->SpawnActor<ASideScrollingCameraManager>(SpawnParams) : nullptr;
+		AActor* Target = SpawnBenchmarkActor(World, LoadBenchmarkClass(this, Settings->AttackerClass, TEXT("AttackerClass")), FVector::ZeroVector);
+
+		if (CameraManager && Target)
+		{
+			CameraManager->InitializeFor(PC);
+
+			FTViewTarget ViewTarget;
+			ViewTarget.Target = Target;
+
+			const float DeltaTime = 1.0f / 60.0f;
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				CameraManager->UpdateViewTarget(ViewTarget, DeltaTime);
+			}
+
+			Report.Add(this, TEXT("UpdateViewTarget"), 1, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+		} else {
+
+			AddError(TEXT("Couldn't spawn the camera or its target"));
+		}
+
+		if (CameraManager)
+		{
+			CameraManager->Destroy();
+		}
+
+		if (Target)
+		{
+			Target->Destroy();
+		}
+
+		if (SpawnedPC)
+		{
+			SpawnedPC->Destroy();
+		}
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWaveSpawnBenchmarkTest, "NetworkCompulsory.Benchmarks.WaveSpawn", TestFlags)
+
+bool FWaveSpawnBenchmarkTest::RunTest(const FString& Parameters)
+{
+	RunSyncBenchmark(this, TEXT("WaveSpawn"), [this](UWorld* World, FBenchmarkReport& Report)
+	{
+		const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+		UClass* Class = LoadBenchmarkClass(this, Settings->EnemyClass, TEXT("EnemyClass"));
+
+		if (!Class)
+		{
+			return;
+		}
+
+		for (const int32 Count : Settings->ActorCounts)
+		{
+			if (Count < 1)
+			{
+				continue;
+			}
+
+			TArray<TWeakObjectPtr<AActor>> Wave;
+
+			// spawn the whole wave in one frame, like the enemy spawner does
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Wave.Add(SpawnBenchmarkActor(World, Class, FVector((Index % 10) * 150.0f, (Index / 10) * 150.0f, 100.0f)));
+			}
+
+			Report.Add(this, TEXT("WaveSpawn"), Count, Count, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			DestroyBenchmarkActors(Wave);
+		}
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDamageBenchmarkTest, "NetworkCompulsory.Benchmarks.Damage", TestFlags)
+
+bool FDamageBenchmarkTest::RunTest(const FString& Parameters)
+{
+	RunSyncBenchmark(this, TEXT("Damage"), [this](UWorld* World, FBenchmarkReport& Report)
+	{
+		const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+
+		UClass* TargetClass = LoadBenchmarkClass(this, Settings->DamageableClass, TEXT("DamageableClass"));
+		UCombatDamageSubsystem* DamageSubsystem = World->GetSubsystem<UCombatDamageSubsystem>();
+
+		if (!TargetClass || !DamageSubsystem)
+		{
+			return;
+		}
+
+		AActor* Causer = SpawnBenchmarkActor(World, LoadBenchmarkClass(this, Settings->AttackerClass, TEXT("AttackerClass")), FVector::ZeroVector);
+
+		for (const int32 Count : Settings->ActorCounts)
+		{
+			if (Count < 1)
+			{
+				continue;
+			}
+
+			TArray<TWeakObjectPtr<AActor>> Targets;
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Targets.Add(SpawnBenchmarkActor(World, TargetClass, FVector(300.0f + (Index % 10) * 100.0f, (Index / 10) * 100.0f, 0.0f)));
+			}
+
+			// apply damage straight through the damageable interface
+			uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Targets[Index % Count].Get()))
+				{
+					Damageable->ApplyDamage(1.0f, Causer, Settings->Origin, FVector::ZeroVector);
+				}
+			}
+
+			Report.Add(this, TEXT("ApplyDamage"), Count, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			// apply a queued batch through the damage subsystem
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				DamageSubsystem->QueueDamage(Targets[Index % Count].Get(), 1.0f, Causer, Settings->Origin, FVector::ZeroVector);
+			}
+
+			StartCycles = FPlatformTime::Cycles64();
+
+			DamageSubsystem->Tick(0.0f);
+
+			Report.Add(this, TEXT("QueuedDamageBatch"), Count, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			// go through the engine damage path
+			StartCycles = FPlatformTime::Cycles64();
+
+			for (int32 Index = 0; Index < Settings->Iterations; ++Index)
+			{
+				UGameplayStatics::ApplyDamage(Targets[Index % Count].Get(), 1.0f, nullptr, Causer, UDamageType::StaticClass());
+			}
+
+			Report.Add(this, TEXT("TakeDamage"), Count, Settings->Iterations, CyclesToMs(StartCycles, FPlatformTime::Cycles64()));
+
+			DestroyBenchmarkActors(Targets);
+		}
+
+		if (Causer)
+		{
+			Causer->Destroy();
+		}
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStateTreeBenchmarkTest, "NetworkCompulsory.Benchmarks.StateTree", TestFlags)
+
+bool FStateTreeBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const UGameplayBenchmarkSettings* Settings = GetDefault<UGameplayBenchmarkSettings>();
+
+	AutomationOpenMap(Settings->Map);
+
+	/** State shared by the latent steps */
+	struct FStateTreeBenchmarkState
+	{
+		FBenchmarkReport Report;
+		TArray<TWeakObjectPtr<AActor>> Enemies;
+		TArray<TWeakObjectPtr<UStateTreeAIComponent>> StateTrees;
+		int32 Frames = 0;
+		double TotalMs = 0.0;
+	};
+
+	for (const int32 Count : Settings->ActorCounts)
+	{
+		if (Count < 1)
+		{
+			continue;
+		}
+
+		TSharedRef<FStateTreeBenchmarkState> State = MakeShared<FStateTreeBenchmarkState>();
+
+		// spawn the AIs. Their StateTrees start ticking on the next frame
+		ADD_LATENT_AUTOMATION_COMMAND(FBenchmarkStepCommand(this, [this, State, Count](UWorld* World)
+		{
+			UClass* Class = LoadBenchmarkClass(this, GetDefault<UGameplayBenchmarkSettings>()->EnemyClass, TEXT("EnemyClass"));
+
+			for (int32 Index = 0; Class && Index < Count; ++Index)
+			{
+				State->Enemies.Add(SpawnBenchmarkActor(World, Class, FVector((Index % 10) * 150.0f, (Index / 10) * 150.0f, 100.0f)));
+			}
+
+			return true;
+		}));
+
+		// let the AIs settle, then take over ticking their StateTrees so we can time them directly
+		ADD_LATENT_AUTOMATION_COMMAND(FBenchmarkStepCommand(this, [State](UWorld* World)
+		{
+			if (++State->Frames < GetDefault<UGameplayBenchmarkSettings>()->WarmupFrames)
+			{
+				return false;
+			}
+
+			for (const TWeakObjectPtr<AActor>& Enemy : State->Enemies)
+			{
+				const APawn* Pawn = Cast<APawn>(Enemy.Get());
+				const AController* Controller = Pawn ? Pawn->GetController() : nullptr;
+
+				if (UStateTreeAIComponent* StateTree = Controller ? Controller->FindComponentByClass<UStateTreeAIComponent>() : nullptr)
+				{
+					StateTree->SetComponentTickEnabled(false);
+					State->StateTrees.Add(StateTree);
+				}
+			}
+
+			State->Frames = 0;
+			return true;
+		}));
+
+		// tick every StateTree once per frame under the timer
+		ADD_LATENT_AUTOMATION_COMMAND(FBenchmarkStepCommand(this, [this, State, Count](UWorld* World)
+		{
+			const int32 MeasureFrames = GetDefault<UGameplayBenchmarkSettings>()->MeasureFrames;
+			const float DeltaTime = World->GetDeltaSeconds();
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (const TWeakObjectPtr<UStateTreeAIComponent>& StateTree : State->StateTrees)
+			{
+				if (StateTree.IsValid())
+				{
+					StateTree->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+				}
+			}
+
+			State->TotalMs += CyclesToMs(StartCycles, FPlatformTime::Cycles64());
+
+			if (++State->Frames < MeasureFrames)
+			{
+				return false;
+			}
+
+			TestEqual(TEXT("StateTree components found"), State->StateTrees.Num(), Count);
+
+			State->Report.Add(this, TEXT("StateTreeTick"), Count, MeasureFrames, State->TotalMs);
+			State->Report.Write(this, FString::Printf(TEXT("StateTree%d"), Count), World);
+
+			DestroyBenchmarkActors(State->Enemies);
+			return true;
+		}));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
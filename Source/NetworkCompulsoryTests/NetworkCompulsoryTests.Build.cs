@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class NetworkCompulsoryTests : ModuleRules
+{
+	public NetworkCompulsoryTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"Core",
+			"CoreUObject",
+			"Engine",
+			"AIModule",
+			"StateTreeModule",
+			"GameplayStateTreeModule",
+			"NetworkCompulsory"
+		});
+	}
+}